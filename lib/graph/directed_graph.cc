@@ -30,6 +30,16 @@ directed_graph& directed_graph::operator=(const directed_graph &gr)
 	return (*this);
 }
 
+directed_graph::directed_graph(directed_graph &&gr) noexcept
+	: graph_base(std::move(gr))
+{}
+
+directed_graph& directed_graph::operator=(directed_graph &&gr) noexcept
+{
+	graph_base::operator=(std::move(gr));
+	return (*this);
+}
+
 directed_graph::~directed_graph()
 {
 }
@@ -38,9 +48,7 @@ edge_descriptor directed_graph::add_edge(int s, int t)
 {
 	assert(s >= 0 && s < vv.size());
 	assert(t >= 0 && t < vv.size());
-	edge_base *e = new edge_base(s, t);
-	assert(se.find(e) == se.end());
-	se.insert(e);
+	edge_base *e = new_edge(s, t);
 	vv[s]->add_out_edge(e);
 	vv[t]->add_in_edge(e);
 	return e;
@@ -48,11 +56,10 @@ edge_descriptor directed_graph::add_edge(int s, int t)
 
 int directed_graph::remove_edge(edge_descriptor e)
 {
-	if(se.find(e) == se.end()) return -1;
+	if(contain_edge(e) == false) return -1;
 	vv[e->source()]->remove_out_edge(e);
 	vv[e->target()]->remove_in_edge(e);
-	delete e;
-	se.erase(e);
+	free_edge(e);
 	return 0;
 }
 
@@ -63,7 +70,7 @@ int directed_graph::exchange(int x, int y, int z)
 	assert(z >= 0 && z < num_vertices());
 
 	edge_iterator it1, it2;
-	set<edge_descriptor> m;
+	SE m;
 	for(tie(it1, it2) = out_edges(x); it1 != it2; it1++)
 	{
 		if(check_path((*it1)->target(), y) == false) continue;
@@ -85,7 +92,7 @@ int directed_graph::exchange(int x, int y, int z)
 		m.insert(*it1);
 	}
 
-	for(set<edge_descriptor>::iterator it = m.begin(); it != m.end(); it++)
+	for(SE::iterator it = m.begin(); it != m.end(); it++)
 	{
 		int s = (*it)->source();
 		int t = (*it)->target();
@@ -104,11 +111,11 @@ int directed_graph::rotate(int x, int y)
 {
 	if(check_path(y, x) == true) return rotate(y, x);
 
-	set<edge_descriptor> se;
+	SE se;
 	int f = check_nest(x, y, se);
 	assert(f >= 0);
 
-	for(set<edge_descriptor>::iterator it = se.begin(); it != se.end(); it++)
+	for(SE::iterator it = se.begin(); it != se.end(); it++)
 	{
 		int s = (*it)->source();
 		int t = (*it)->target();
@@ -178,7 +185,7 @@ int directed_graph::move_edge(edge_base *e, int x, int y)
 	return 0;
 }
 
-bool directed_graph::bfs_reverse(const vector<int> &t, int s, const set<edge_descriptor> &fb)
+bool directed_graph::bfs_reverse(const vector<int> &t, int s, const SE &fb)
 {
 	vector<int> open = t;
 	set<int> closed(t.begin(), t.end());
@@ -234,7 +241,7 @@ int directed_graph::bfs_reverse(int t, vector<int> &v, vector<int> &b)
 	return 0;
 }
 
-int directed_graph::bfs_reverse(int t, set<edge_descriptor> &ss)
+int directed_graph::bfs_reverse(int t, SE &ss)
 {
 	ss.clear();
 	set<int> closed;
@@ -426,7 +433,7 @@ int directed_graph::compute_in_partner(int x)
 		order[v[i]] = i;
 	}
 
-	set<edge_descriptor> se;
+	SE se;
 	set<int> sv;
 	edge_iterator it1, it2;
 	for(tie(it1, it2) = in_edges(x); it1 != it2; it1++)
@@ -477,7 +484,7 @@ int directed_graph::compute_out_partner(int x)
 		order[v[i]] = i;
 	}
 
-	set<edge_descriptor> se;
+	SE se;
 	set<int> sv;
 	edge_iterator it1, it2;
 	for(tie(it1, it2) = out_edges(x); it1 != it2; it1++)
@@ -617,11 +624,11 @@ int directed_graph::compute_in_equivalent_vertex(int x)
 
 int directed_graph::check_nest(int x, int y, const vector<int> &tpo)
 {
-	set<edge_descriptor> se;
+	SE se;
 	return check_nest(x, y, se, tpo);
 }
 
-int directed_graph::check_nest(int x, int y, set<edge_descriptor> &se)
+int directed_graph::check_nest(int x, int y, SE &se)
 {
 	vector<int> v = topological_sort();
 	vector<int> tpo;
@@ -633,7 +640,7 @@ int directed_graph::check_nest(int x, int y, set<edge_descriptor> &se)
 	return check_nest(x, y, se, tpo);
 }
 
-int directed_graph::check_nest(int x, int y, set<edge_descriptor> &se, const vector<int> &tpo)
+int directed_graph::check_nest(int x, int y, SE &se, const vector<int> &tpo)
 {
 	vector<int> rv;
 	bfs_reverse(y, rv);
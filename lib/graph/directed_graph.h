@@ -20,6 +20,8 @@ public:
 	directed_graph();
 	directed_graph(const directed_graph &gr);
 	directed_graph& operator=(const directed_graph &gr);
+	directed_graph(directed_graph &&gr) noexcept;
+	directed_graph& operator=(directed_graph &&gr) noexcept;
 	virtual ~directed_graph();
 
 public:
@@ -40,8 +42,8 @@ public:
 	// algorithms
 	virtual int bfs_reverse(int t, vector<int> &v);
 	virtual int bfs_reverse(int t, vector<int> &v, vector<int> &b);
-	virtual int bfs_reverse(int t, set<edge_descriptor> &ss);
-	virtual bool bfs_reverse(const vector<int> &vt, int s, const set<edge_descriptor> &fb);
+	virtual int bfs_reverse(int t, SE &ss);
+	virtual bool bfs_reverse(const vector<int> &vt, int s, const SE &fb);
 	virtual bool compute_shortest_path(int x, int y, vector<int> &p);
 	virtual bool compute_shortest_path(edge_descriptor ex, edge_descriptor ey, vector<int> &p);
 	virtual bool check_path(int x, int y);
@@ -54,8 +56,8 @@ public:
 	virtual int compute_out_partner(int x);
 	virtual int compute_in_equivalent_vertex(int x);
 	virtual int compute_out_equivalent_vertex(int x);
-	virtual int check_nest(int x, int r, set<edge_descriptor> &vv);
-	virtual int check_nest(int x, int r, set<edge_descriptor> &vv, const vector<int> &tpo);
+	virtual int check_nest(int x, int r, SE &vv);
+	virtual int check_nest(int x, int r, SE &vv, const vector<int> &tpo);
 	virtual int check_nest(int x, int r, const vector<int> &tpo);
 
 	// draw
@@ -9,8 +9,8 @@ See LICENSE for licensing.
 
 using namespace std;
 
-edge_base::edge_base(int _s, int _t)
-	:s(_s), t(_t)
+edge_base::edge_base(int _s, int _t, int _id)
+	:s(_s), t(_t), id(_id)
 {}
 
 int edge_base::move(int x, int y)
@@ -38,6 +38,11 @@ int edge_base::target() const
 	return t;
 }
 
+int edge_base::index() const
+{
+	return id;
+}
+
 int edge_base::print() const
 {
 	printf("edge %d -> %d\n", s, t);
@@ -7,8 +7,10 @@ See LICENSE for licensing.
 #ifndef __EDGE_BASE_H__
 #define __EDGE_BASE_H__
 
+#include <cstddef>
 #include <set>
 #include <map>
+#include <vector>
 
 using namespace std;
 
@@ -17,25 +19,88 @@ using namespace std;
 class edge_base
 {
 public:
-	edge_base(int _s, int _t);
+	edge_base(int _s, int _t, int _id = -1);
 
 protected:
 	int s;					// source
 	int t;					// target
+	int id;					// index in the edges of its graph, never reused there
 
 public:
 	virtual int move(int x, int y);
 	virtual int swap();
 	virtual int source() const;
 	virtual int target() const;
+	virtual int index() const;
 	virtual int print() const;
 };
 
+// walks a range of edges, skipping the NULL slots left by removed edges
+class edge_iterator
+{
+public:
+	typedef vector<edge_base*>::const_iterator slot_iterator;
+
+	edge_iterator()
+	{}
+
+	edge_iterator(slot_iterator _p, slot_iterator _q)
+		:p(_p), q(_q)
+	{
+		while(p != q && *p == NULL) p++;
+	}
+
+private:
+	slot_iterator p;		// current slot
+	slot_iterator q;		// end of the range
+
+public:
+	edge_base* operator*() const
+	{
+		return *p;
+	}
+
+	edge_iterator& operator++()
+	{
+		p++;
+		while(p != q && *p == NULL) p++;
+		return *this;
+	}
+
+	edge_iterator operator++(int)
+	{
+		edge_iterator x = *this;
+		++(*this);
+		return x;
+	}
+
+	bool operator==(const edge_iterator &x) const
+	{
+		return p == x.p;
+	}
+
+	bool operator!=(const edge_iterator &x) const
+	{
+		return p != x.p;
+	}
+};
+
+// orders edges by index, i.e., by creation within their graph, so that
+// iterating over a set or map of edges does not depend on heap addresses
+struct edge_cmp
+{
+	bool operator()(const edge_base *x, const edge_base *y) const
+	{
+		if(x == NULL || y == NULL) return x < y;
+		if(x->index() != y->index()) return x->index() < y->index();
+		return x < y;
+	}
+};
+
 typedef edge_base* edge_descriptor;
-typedef set<edge_base*>::iterator edge_iterator;
 typedef pair<edge_descriptor, bool> PEB;
 typedef pair<edge_descriptor, edge_descriptor> PEE;
-typedef map<edge_descriptor, edge_descriptor> MEE;
+typedef map<edge_descriptor, edge_descriptor, edge_cmp> MEE;
 typedef pair<edge_iterator, edge_iterator> PEEI;
 
 #endif
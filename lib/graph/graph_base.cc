@@ -11,11 +11,15 @@ See LICENSE for licensing.
 #include <cassert>
 #include <tuple>
 #include <algorithm>
+#include <new>
+#include <type_traits>
 
 using namespace std;
 
 graph_base::graph_base()
-{}
+{
+	ne = 0;
+}
 
 graph_base::~graph_base()
 {
@@ -24,9 +28,32 @@ graph_base::~graph_base()
 
 graph_base::graph_base(const graph_base &gr)
 {
+	ne = 0;
 	//copy(gr); !!!
 }
 
+// take over the vertices, edges and their memory, leaving gr empty;
+// edge descriptors of gr stay valid and now refer to this graph
+graph_base::graph_base(graph_base &&gr) noexcept
+	: vv(std::move(gr.vv)), ve(std::move(gr.ve)), ne(gr.ne), gmem(std::move(gr.gmem))
+{
+	gr.vv.clear();
+	gr.ve.clear();
+	gr.ne = 0;
+}
+
+graph_base& graph_base::operator=(graph_base &&gr) noexcept
+{
+	if(this == &gr) return (*this);
+	clear();
+	vv.swap(gr.vv);
+	ve.swap(gr.ve);
+	ne = gr.ne;
+	gr.ne = 0;
+	gmem = std::move(gr.gmem);
+	return (*this);
+}
+
 int graph_base::copy(const graph_base &gr)
 {
 	clear();
@@ -42,7 +69,7 @@ int graph_base::copy(const graph_base &gr)
 
 int graph_base::add_vertex()
 {
-	vertex_base *v = new vertex_base();
+	vertex_base *v = new(gmem.allocate(sizeof(vertex_base))) vertex_base();
 	vv.push_back(v);
 	return 0;
 }
@@ -69,13 +96,40 @@ int graph_base::clear_vertex(int x)
 
 int graph_base::clear()
 {
-	for(int i = 0; i < vv.size(); i++) delete vv[i];
-	for(edge_iterator it = se.begin(); it != se.end(); it++)
-	{
-		delete (*it);
-	}
+	// edges need no destructor, so the arena releases them at once
+	static_assert(is_trivially_destructible<edge_base>::value, "edge_base must be trivially destructible");
+	for(int i = 0; i < vv.size(); i++) vv[i]->~vertex_base();
 	vv.clear();
-	se.clear();
+	ve.clear();
+	ne = 0;
+	gmem.clear();
+	return 0;
+}
+
+edge_base* graph_base::new_edge(int s, int t)
+{
+	// indices are not reused, so ve stays sorted by creation
+	edge_base *e = new(gmem.allocate(sizeof(edge_base))) edge_base(s, t, ve.size());
+	ve.push_back(e);
+	ne++;
+	return e;
+}
+
+bool graph_base::contain_edge(edge_base *e) const
+{
+	if(e == null_edge) return false;
+	int k = e->index();
+	if(k < 0 || k >= ve.size()) return false;
+	return (ve[k] == e);
+}
+
+int graph_base::free_edge(edge_base *e)
+{
+	// callers may still hold a removed edge as a key of an edge_cmp
+	// ordered map, so it stays intact in gmem until clear()
+	assert(contain_edge(e) == true);
+	ve[e->index()] = NULL;
+	ne--;
 	return 0;
 }
 
@@ -114,7 +168,7 @@ vector<edge_descriptor> graph_base::edges(int s, int t)
 
 PEEI graph_base::edges() const
 {
-	return PEEI(se.begin(), se.end());
+	return PEEI(edge_iterator(ve.begin(), ve.end()), edge_iterator(ve.end(), ve.end()));
 }
 
 set<int> graph_base::adjacent_vertices(int s)
@@ -148,7 +202,7 @@ size_t graph_base::num_vertices() const
 
 size_t graph_base::num_edges() const
 {
-	return se.size();
+	return ne;
 }
 
 int graph_base::get_edge_indices(VE &i2e, MEI &e2i)
@@ -166,7 +220,7 @@ int graph_base::get_edge_indices(VE &i2e, MEI &e2i)
 	return 0;
 }
 
-bool graph_base::bfs(const vector<int> &vs, int t, const set<edge_descriptor> &fb)
+bool graph_base::bfs(const vector<int> &vs, int t, const SE &fb)
 {
 	set<int> closed(vs.begin(), vs.end());
 	vector<int> open = vs;
@@ -219,7 +273,7 @@ int graph_base::bfs(int s, vector<int> &v, vector<int> &b)
 	return 0;
 }
 
-int graph_base::bfs(int s, set<edge_descriptor> &ss)
+int graph_base::bfs(int s, SE &ss)
 {
 	ss.clear();
 	set<int> closed;
@@ -253,7 +307,7 @@ int graph_base::bfs(int t, vector<int> &v)
 
 bool graph_base::check_path(int s, int t) 
 {
-	set<edge_descriptor> fb;
+	SE fb;
 	vector<int> ss;
 	ss.push_back(s);
 	return bfs(ss, t, fb);
@@ -306,14 +360,15 @@ bool graph_base::check_nested()
 
 int graph_base::print() const
 {
-	printf("total %lu vertices, %lu edges\n", vv.size(), se.size());
+	printf("total %lu vertices, %lu edges\n", vv.size(), ne);
 	for(int i = 0; i < vv.size(); i++)
 	{
 		printf("vertex %d: ", i);
 		vv[i]->print();
 	}
 
-	for(edge_iterator it = se.begin(); it != se.end(); it++)
+	PEEI p = edges();
+	for(edge_iterator it = p.first; it != p.second; it++)
 	{
 		(*it)->print();
 	}
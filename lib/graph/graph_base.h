@@ -13,31 +13,36 @@ See LICENSE for licensing.
 
 #include "vertex_base.h"
 #include "edge_base.h"
+#include "arena.h"
 
 using namespace std;
 
 typedef map<int, string> MIS;
 typedef pair<int, string> PIS;
-typedef map<edge_descriptor, string> MES;
+typedef map<edge_descriptor, string, edge_cmp> MES;
 typedef pair<edge_descriptor, string> PES;
-typedef map<edge_descriptor, bool> MEB;
-typedef map<edge_descriptor, double> MED;
+typedef map<edge_descriptor, bool, edge_cmp> MEB;
+typedef map<edge_descriptor, double, edge_cmp> MED;
 typedef pair<edge_descriptor, double> PED;
-typedef map<edge_descriptor, int> MEI;
+typedef map<edge_descriptor, int, edge_cmp> MEI;
 typedef pair<edge_descriptor, int> PEI;
 typedef vector<edge_descriptor> VE;
-typedef set<edge_descriptor> SE;
+typedef set<edge_descriptor, edge_cmp> SE;
 
 class graph_base
 {
 public:
 	graph_base();
 	graph_base(const graph_base &gr);
+	graph_base(graph_base &&gr) noexcept;
+	graph_base& operator=(graph_base &&gr) noexcept;
 	virtual ~graph_base();
 
 protected:
 	vector<vertex_base*> vv;
-	set<edge_base*> se;
+	vector<edge_base*> ve;		// edges by index, NULL once removed
+	size_t ne;					// number of edges in ve
+	arena gmem;					// vertices and edges, all released in clear()
 
 public:
 	// modify the graph
@@ -64,8 +69,8 @@ public:
 	// algorithms
 	virtual int bfs(int s, vector<int> &v);
 	virtual int bfs(int s, vector<int> &v, vector<int> &b);
-	virtual int bfs(int s, set<edge_descriptor> &ss);
-	virtual bool bfs(const vector<int> &vs, int t, const set<edge_descriptor> &fb);
+	virtual int bfs(int s, SE &ss);
+	virtual bool bfs(const vector<int> &vs, int t, const SE &fb);
 	virtual bool check_path(int s, int t);
 	virtual bool compute_shortest_path(int s, int t, vector<int> &p);
 	virtual bool check_nested();
@@ -74,6 +79,11 @@ public:
 	// draw
 	virtual int draw(const string &file, const MIS &mis, const MES &mes, double len) = 0;
 	virtual int print() const;
+
+protected:
+	edge_base* new_edge(int s, int t);
+	bool contain_edge(edge_base *e) const;
+	int free_edge(edge_base *e);
 };
 
 #endif
@@ -20,6 +20,8 @@ public:
 	undirected_graph();
 	undirected_graph(const undirected_graph &gr);
 	undirected_graph& operator=(const undirected_graph &gr);
+	undirected_graph(undirected_graph &&gr) noexcept;
+	undirected_graph& operator=(undirected_graph &&gr) noexcept;
 	virtual ~undirected_graph();
 
 public:
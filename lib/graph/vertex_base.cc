@@ -9,7 +9,7 @@ See LICENSE for licensing.
 
 #include <cstdio>
 #include <cassert>
-#include <cstdio>
+#include <algorithm>
 
 using namespace std;
 
@@ -19,32 +19,46 @@ vertex_base::vertex_base()
 vertex_base::~vertex_base()
 {}
 
-int vertex_base::add_in_edge(edge_base *e)
+static bool edge_index_cmp(const edge_base *x, const edge_base *y)
+{
+	return x->index() < y->index();
+}
+
+int vertex_base::insert_edge(vector<edge_base*> &v, edge_base *e)
 {
-	assert(si.find(e) == si.end());
-	si.insert(e);
+	// new edges have the largest index, so this mostly appends
+	vector<edge_base*>::iterator it = upper_bound(v.begin(), v.end(), e, edge_index_cmp);
+	assert(it == v.begin() || *(it - 1) != e);
+	v.insert(it, e);
 	return 0;
 }
 
-int vertex_base::add_out_edge(edge_base *e)
+int vertex_base::erase_edge(vector<edge_base*> &v, edge_base *e)
 {
-	assert(so.find(e) == so.end());
-	so.insert(e);
+	vector<edge_base*>::iterator it = lower_bound(v.begin(), v.end(), e, edge_index_cmp);
+	assert(it != v.end() && *it == e);
+	v.erase(it);
 	return 0;
 }
 
+int vertex_base::add_in_edge(edge_base *e)
+{
+	return insert_edge(si, e);
+}
+
+int vertex_base::add_out_edge(edge_base *e)
+{
+	return insert_edge(so, e);
+}
+
 int vertex_base::remove_in_edge(edge_base *e)
 {
-	assert(si.find(e) != si.end());
-	si.erase(e);
-	return 0;
+	return erase_edge(si, e);
 }
 
 int vertex_base::remove_out_edge(edge_base *e)
 {
-	assert(so.find(e) != so.end());
-	so.erase(e);
-	return 0;
+	return erase_edge(so, e);
 }
 
 int vertex_base::degree() const
@@ -64,25 +78,25 @@ int vertex_base::out_degree() const
 
 PEEI vertex_base::in_edges() const
 {
-	return PEEI(si.begin(), si.end());
+	return PEEI(edge_iterator(si.begin(), si.end()), edge_iterator(si.end(), si.end()));
 }
 
 PEEI vertex_base::out_edges() const
 {
-	return PEEI(so.begin(), so.end());
+	return PEEI(edge_iterator(so.begin(), so.end()), edge_iterator(so.end(), so.end()));
 }
 
 int vertex_base::print() const
 {
 	printf("in-edges = ( ");
-	for(edge_iterator it = si.begin(); it != si.end(); it++)
+	for(int i = 0; i < si.size(); i++)
 	{
-		printf("[%d, %d] ", (*it)->source(), (*it)->target());
+		printf("[%d, %d] ", si[i]->source(), si[i]->target());
 	}
 	printf("), out-edges = ( ");
-	for(edge_iterator it = so.begin(); it != so.end(); it++)
+	for(int i = 0; i < so.size(); i++)
 	{
-		printf("[%d, %d] ", (*it)->source(), (*it)->target());
+		printf("[%d, %d] ", so[i]->source(), so[i]->target());
 	}
 	printf(")\n");
 	return 0;
@@ -7,7 +7,7 @@ See LICENSE for licensing.
 #ifndef __VERTEX_BASE_H__
 #define __VERTEX_BASE_H__
 
-#include <set>
+#include <vector>
 #include "edge_base.h"
 
 using namespace std;
@@ -19,8 +19,8 @@ public:
 	virtual ~vertex_base();
 
 protected:
-	set<edge_base*> si;		// in_edges
-	set<edge_base*> so;		// out_edges
+	vector<edge_base*> si;	// in_edges, sorted by index
+	vector<edge_base*> so;	// out_edges, sorted by index
 
 public:
 	virtual int add_in_edge(edge_base *e);
@@ -33,6 +33,10 @@ public:
 	virtual PEEI in_edges() const;
 	virtual PEEI out_edges() const;
 	virtual int print() const;
+
+private:
+	static int insert_edge(vector<edge_base*> &v, edge_base *e);
+	static int erase_edge(vector<edge_base*> &v, edge_base *e);
 };
 
 #endif
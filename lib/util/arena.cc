@@ -0,0 +1,91 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include <cstdlib>
+#include <cassert>
+#include <new>
+
+#include "arena.h"
+
+// size of a regular block; larger requests get a block of their own
+#define ARENA_BLOCK_SIZE 65536
+
+arena::arena()
+	: cur(NULL), left(0), bytes(0)
+{}
+
+arena::arena(arena &&a) noexcept
+	: blocks(std::move(a.blocks)), cur(a.cur), left(a.left), bytes(a.bytes)
+{
+	a.blocks.clear();
+	a.cur = NULL;
+	a.left = 0;
+	a.bytes = 0;
+}
+
+arena& arena::operator=(arena &&a) noexcept
+{
+	if(this == &a) return *this;
+	clear();
+	blocks.swap(a.blocks);
+	cur = a.cur;
+	left = a.left;
+	bytes = a.bytes;
+	a.cur = NULL;
+	a.left = 0;
+	a.bytes = 0;
+	return *this;
+}
+
+arena::~arena()
+{
+	clear();
+}
+
+void *arena::allocate(size_t n)
+{
+	// keep every allocation aligned to 8 bytes
+	n = (n + 7) & ~((size_t)7);
+	bytes += n;
+
+	if(n > left && n > ARENA_BLOCK_SIZE / 4)
+	{
+		// a large request must not waste the rest of the current block
+		char *b = (char*)malloc(n);
+		if(b == NULL) throw bad_alloc();
+		if(blocks.size() == 0) blocks.push_back(b);
+		else blocks.insert(blocks.end() - 1, b);
+		return b;
+	}
+
+	if(n > left)
+	{
+		cur = (char*)malloc(ARENA_BLOCK_SIZE);
+		if(cur == NULL) throw bad_alloc();
+		blocks.push_back(cur);
+		left = ARENA_BLOCK_SIZE;
+	}
+
+	void *p = cur;
+	cur += n;
+	left -= n;
+	return p;
+}
+
+int arena::clear()
+{
+	for(int i = 0; i < blocks.size(); i++) free(blocks[i]);
+	blocks.clear();
+	cur = NULL;
+	left = 0;
+	bytes = 0;
+	return 0;
+}
+
+size_t arena::size() const
+{
+	return bytes;
+}
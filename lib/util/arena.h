@@ -0,0 +1,48 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+// a bump allocator handing out memory from large blocks;
+// blocks are never moved or freed before clear(), so pointers
+// stay valid for the lifetime of the arena, also across a move
+class arena
+{
+public:
+	arena();
+	arena(arena &&a) noexcept;
+	arena& operator=(arena &&a) noexcept;
+	arena(const arena &a) = delete;
+	arena& operator=(const arena &a) = delete;
+	~arena();
+
+private:
+	vector<char*> blocks;	// allocated blocks
+	char *cur;				// first free byte in the last block
+	size_t left;			// number of free bytes in the last block
+	size_t bytes;			// number of bytes handed out
+
+public:
+	void *allocate(size_t n);
+	int clear();
+	size_t size() const;
+
+	template<typename T> T *copy(const T *p, size_t n)
+	{
+		T *q = (T*)allocate(n * sizeof(T));
+		if(n >= 1) memcpy(q, p, n * sizeof(T));
+		return q;
+	}
+};
+
+#endif
@@ -123,7 +123,7 @@ int compute_mean_dev(const vector<T> &v, int si, int ti, double &ave, double &de
 
 	ave = sum * 1.0 / (ti - si);
 
-	double var;
+	double var = 0;
 	for(int i = si ; i < ti; i++)
 	{
 		var += (v[i] - ave) * (v[i] - ave);
@@ -5,8 +5,11 @@ See LICENSE for licensing.
 */
 
 #include <cstdio>
+#include <cstdlib>
 #include <cassert>
 #include <sstream>
+#include <chrono>
+#include <memory>
 
 #include "config.h"
 #include "gtf.h"
@@ -17,27 +20,97 @@ See LICENSE for licensing.
 #include "super_graph.h"
 #include "filter.h"
 
-assembler::assembler()
+assembler::assembler(htsThreadPool *tp)
 {
+	open(tp);
+	idx = NULL;
+	itr = NULL;
+	rbeg = 0;
+	tpool = NULL;
+	if(num_threads >= 2) tpool = new thread_pool(num_threads, 2 * num_threads);
+	if(tpool != NULL) idx = sam_index_load(sfn, input_file.c_str());
+	rpool = tpool;
+}
+
+assembler::assembler(htsThreadPool *tp, hts_idx_t *x, int tid, int32_t beg, int32_t end)
+{
+	open(tp);
+	idx = NULL;
+	itr = sam_itr_queryi(x, tid, beg, end);
+	rbeg = beg;
+	tpool = NULL;
+	rpool = NULL;
+}
+
+assembler::~assembler()
+{
+	if(tpool != NULL) delete tpool;
+	if(idx != NULL) hts_idx_destroy(idx);
+	close();
+}
+
+int assembler::open(htsThreadPool *tp)
+{
+	hpool = tp;
     sfn = sam_open(input_file.c_str(), "r");
+	if(tp != NULL && tp->pool != NULL) hts_set_thread_pool(sfn, tp);
     hdr = sam_hdr_read(sfn);
     b1t = bam_init1();
+	rtime = 0;
 	index = 0;
+	nskip = 0;
+	merged = 0;
 	terminate = false;
 	qlen = 0;
 	qcnt = 0;
+	return 0;
 }
 
-assembler::~assembler()
+int assembler::close()
 {
-    bam_destroy1(b1t);
-    bam_hdr_destroy(hdr);
-    sam_close(sfn);
+	if(itr != NULL) hts_itr_destroy(itr);
+	if(b1t != NULL) bam_destroy1(b1t);
+	if(hdr != NULL) bam_hdr_destroy(hdr);
+	if(sfn != NULL) sam_close(sfn);
+	itr = NULL;
+	b1t = NULL;
+	hdr = NULL;
+	sfn = NULL;
+	return 0;
 }
 
 int assembler::assemble()
 {
-    while(sam_read1(sfn, hdr, b1t) >= 0)
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+
+	if(idx != NULL) assemble_shards();
+	else assemble_hits();
+
+	if(terminate == true) return 0;
+
+	assign_RPKM();
+
+	filter ft(trsts);
+	ft.merge_single_exon_transcripts();
+	trsts = ft.trs;
+
+	write();
+
+	if(verbose >= 1)
+	{
+		double t = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+		// shards are read concurrently, so their reading times add up to more than the wall clock
+		if(idx == NULL) printf("assemble: %.2lf seconds in total, %.2lf seconds spent in reading and decompressing the input\n", t, rtime);
+		else printf("assemble: %.2lf seconds in total, %.2lf seconds spent in reading and decompressing the input, summed over shards\n", t, rtime);
+		printf("assemble: %d bundles in total, %d skipped as too short to yield a transcript\n", index, nskip);
+	}
+	
+	return 0;
+}
+
+int assembler::assemble_hits()
+{
+    while(read() >= 0)
 	{
 		if(terminate == true) return 0;
 
@@ -45,14 +118,12 @@ int assembler::assemble()
 
 		if((p.flag & 0x4) >= 1) continue;										// read is not mapped
 		if((p.flag & 0x100) >= 1 && use_second_alignment == false) continue;	// secondary alignment
-		if(p.n_cigar > MAX_NUM_CIGAR) continue;									// ignore hits with more than 7 cigar types
 		if(p.qual < min_mapping_quality) continue;								// ignore hits with small quality
 		if(p.n_cigar < 1) continue;												// should never happen
 
 		hit ht(b1t);
 		ht.set_tags(b1t);
 		ht.set_strand();
-		ht.build_splice_positions();
 
 		//ht.print();
 
@@ -66,12 +137,12 @@ int assembler::assemble()
 		// truncate
 		if(ht.tid != bb1.tid || ht.pos > bb1.rpos + min_bundle_gap)
 		{
-			pool.push_back(bb1);
+			pool.push_back(std::move(bb1));
 			bb1.clear();
 		}
 		if(ht.tid != bb2.tid || ht.pos > bb2.rpos + min_bundle_gap)
 		{
-			pool.push_back(bb2);
+			pool.push_back(std::move(bb2));
 			bb2.clear();
 		}
 
@@ -91,21 +162,138 @@ int assembler::assemble()
 		if(library_type == UNSTRANDED && ht.xs == '-') bb2.add_hit(ht);
 	}
 
-	pool.push_back(bb1);
-	pool.push_back(bb2);
+	pool.push_back(std::move(bb1));
+	pool.push_back(std::move(bb2));
 	process(0);
 
-	assign_RPKM();
+	if(tpool != NULL) tpool->wait();
+	assert(pending.size() == 0);
+	return 0;
+}
 
-	filter ft(trsts);
-	ft.merge_single_exon_transcripts();
-	trsts = ft.trs;
+int assembler::assemble_shards()
+{
+	// each shard is read through the index and assembled on its own;
+	// bundles never span shard boundaries, so shards share nothing but the index
+	plan_shards();
+	shards.assign(ranges.size(), NULL);
+	for(int k = 0; k < ranges.size(); k++)
+	{
+		tpool->submit([this, k]() { assemble_shard(k); });
+	}
+	tpool->wait();
 
-	write();
-	
+	// merge in the order of a coordinate-sorted input,
+	// renumbering bundles as if the file had been read through
+	for(int k = 0; k < shards.size(); k++)
+	{
+		assembler *a = shards[k];
+		renumber(a->trsts, index);
+		trsts.insert(trsts.end(), a->trsts.begin(), a->trsts.end());
+		index += a->index;
+		nskip += a->nskip;
+		qlen += a->qlen;
+		qcnt += a->qcnt;
+		rtime += a->rtime;
+		delete a;
+	}
+	shards.clear();
+	ranges.clear();
+	return 0;
+}
+
+int assembler::assemble_shard(int k)
+{
+	int tid = ranges[k].first;
+	assembler *a = new assembler(hpool, idx, tid, ranges[k].second.first, ranges[k].second.second);
+	a->rpool = tpool;
+	if(a->itr != NULL) a->assemble_hits();
+	a->close();
+	shards[k] = a;
 	return 0;
 }
 
+int assembler::plan_shards()
+{
+	// aim at a few shards per thread, so that long chromosomes
+	// are cut into pieces instead of being left as a serial tail
+	int64_t total = 0;
+	for(int i = 0; i < hdr->n_targets; i++) total += hdr->target_len[i];
+	int64_t size = total / (4 * num_threads);
+	if(size < 1000000) size = 1000000;
+
+	ranges.clear();
+	for(int i = 0; i < hdr->n_targets; i++)
+	{
+		int32_t len = hdr->target_len[i];
+		int32_t beg = 0;
+		while(beg + size < len)
+		{
+			int32_t s = find_gap(i, beg + size, len);
+			if(s < 0) break;
+			ranges.push_back(pair<int, PI32>(i, PI32(beg, s)));
+			beg = s;
+		}
+		ranges.push_back(pair<int, PI32>(i, PI32(beg, len)));
+	}
+
+	if(verbose >= 1) printf("assemble: %d chromosomes split into %lu shards\n", hdr->n_targets, ranges.size());
+	return 0;
+}
+
+int32_t assembler::find_gap(int tid, int32_t p, int32_t end)
+{
+	// look for a window [a, a + min_bundle_gap] at or after p that no read overlaps;
+	// every read starting before the window then ends at or before a, and every read
+	// starting after it is more than min_bundle_gap away, so both bundles break there
+	int32_t a = p;
+	while(a + min_bundle_gap + 1 < end)
+	{
+		hts_itr_t *it = sam_itr_queryi(idx, tid, a, a + min_bundle_gap + 1);
+		if(it == NULL) return -1;
+
+		int32_t x = a;
+		while(sam_itr_next(sfn, it, b1t) >= 0)
+		{
+			if((b1t->core.flag & 0x4) >= 1) continue;
+			int32_t e = bam_endpos(b1t);
+			if(e > x) x = e;
+		}
+		hts_itr_destroy(it);
+
+		if(x == a) return a + min_bundle_gap + 1;
+		a = x;
+	}
+	return -1;
+}
+
+int assembler::renumber(vector<transcript> &v, int x)
+{
+	// ids are gene.<bundle>.<graph>[.<path>]; shift <bundle> by x
+	if(x == 0) return 0;
+	for(int i = 0; i < v.size(); i++)
+	{
+		string *s[] = {&v[i].gene_id, &v[i].transcript_id};
+		for(int j = 0; j < 2; j++)
+		{
+			size_t p = s[j]->find('.', 5);
+			int k = atoi(s[j]->substr(5, p - 5).c_str());
+			*s[j] = "gene." + tostring(k + x) + s[j]->substr(p);
+		}
+	}
+	return 0;
+}
+
+int assembler::read()
+{
+	chrono::steady_clock::time_point t = chrono::steady_clock::now();
+	int r = 0;
+	if(itr == NULL) r = sam_read1(sfn, hdr, b1t);
+	else while((r = sam_itr_next(sfn, itr, b1t)) >= 0 && b1t->core.pos < rbeg);
+	rtime += chrono::duration<double>(chrono::steady_clock::now() - t).count();
+	return r;
+}
+
 int assembler::process(int n)
 {
 	if(pool.size() < n) return 0;
@@ -113,34 +301,82 @@ int assembler::process(int n)
 	for(int i = 0; i < pool.size(); i++)
 	{
 		bundle_base &bb = pool[i];
-		if(bb.hits.size() < min_num_hits_in_bundle) continue;
+		if(bb.nhits < min_num_hits_in_bundle) continue;
 		if(bb.tid < 0) continue;
 
 		char buf[1024];
 		strcpy(buf, hdr->target_name[bb.tid]);
+		bb.chrm = string(buf);
 
-		bundle bd(bb);
+		// bundles are numbered in input order, which fixes both
+		// the gene ids and the position of their transcripts in trsts
+		int k = index++;
+		if(bb.hopeless() == true)
+		{
+			vector<transcript> v;
+			collect(k, v);
+			nskip++;
+			continue;
+		}
 
-		bd.chrm = string(buf);
+		if(tpool == NULL)
+		{
+			assemble_bundle(bb, k);
+		}
+		else
+		{
+			// tasks must be copyable, so the bundle travels behind a shared pointer
+			shared_ptr<bundle_base> b = make_shared<bundle_base>(std::move(bb));
+			tpool->submit([this, b, k]() { assemble_bundle(*b, k); });
+		}
+	}
+	pool.clear();
+	return 0;
+}
+
+int assembler::assemble_bundle(bundle_base &bb, int k)
+{
+	// the pieces of a bundle split at coverage valleys share its number,
+	// their graphs are numbered on from those of the previous pieces
+	vector<bundle_base> pieces;
+	bb.split(pieces);
+
+	int g = 0;
+	vector<transcript> v;
+	for(int i = 0; i < pieces.size(); i++)
+	{
+		if(pieces.size() >= 2 && pieces[i].nhits < min_num_hits_in_bundle) continue;
+		if(pieces.size() >= 2 && pieces[i].hopeless() == true) continue;
+
+		bundle bd(std::move(pieces[i]));
+		bd.tpool = rpool;
 		bd.build();
-		if(verbose >= 1) bd.print(index);
+		if(verbose >= 1) bd.print(k);
 
-		assemble(bd.gr, bd.hs);
-		index++;
+		vector<transcript> vt;
+		assemble(std::move(bd.gr), std::move(bd.hs), k, g, vt);
+		v.insert(v.end(), vt.begin(), vt.end());
+		if(terminate == true) break;
 	}
-	pool.clear();
+
+	collect(k, v);
 	return 0;
 }
 
-int assembler::assemble(const splice_graph &gr0, const hyper_set &hs0)
+// the graphs of a bundle are handed over, not copied, from the bundle
+// through the super graph into scallop
+int assembler::assemble(splice_graph &&gr0, hyper_set &&hs0, int k0, int &g, vector<transcript> &v)
 {
-	super_graph sg(gr0, hs0);
+	super_graph sg(std::move(gr0), std::move(hs0));
 	sg.build();
 
+	int g0 = g;
+	g += sg.subs.size();
+
 	vector<transcript> gv;
 	for(int k = 0; k < sg.subs.size(); k++)
 	{
-		string gid = "gene." + tostring(index) + "." + tostring(k);
+		string gid = "gene." + tostring(k0) + "." + tostring(g0 + k);
 		if(fixed_gene_name != "" && gid != fixed_gene_name) continue;
 
 		if(verbose >= 2 && (k == 0 || fixed_gene_name != "")) sg.print();
@@ -149,7 +385,7 @@ int assembler::assemble(const splice_graph &gr0, const hyper_set &hs0)
 		hyper_set &hs = sg.hss[k];
 
 		gr.gid = gid;
-		scallop sc(gr, hs);
+		scallop sc(std::move(gr), std::move(hs));
 		sc.assemble();
 
 		if(verbose >= 2)
@@ -175,8 +411,23 @@ int assembler::assemble(const splice_graph &gr0, const hyper_set &hs0)
 
 	filter ft(gv);
 	ft.remove_nested_transcripts();
-	if(ft.trs.size() >= 1) trsts.insert(trsts.end(), ft.trs.begin(), ft.trs.end());
+	v = ft.trs;
+
+	return 0;
+}
+
+int assembler::collect(int k, vector<transcript> &v)
+{
+	lock_guard<mutex> lock(mtx);
 
+	pending[k].swap(v);
+	while(pending.size() >= 1 && pending.begin()->first == merged)
+	{
+		vector<transcript> &vt = pending.begin()->second;
+		trsts.insert(trsts.end(), vt.begin(), vt.end());
+		pending.erase(pending.begin());
+		merged++;
+	}
 	return 0;
 }
 
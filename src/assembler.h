@@ -9,39 +9,68 @@ See LICENSE for licensing.
 
 #include <fstream>
 #include <string>
+#include <map>
+#include <deque>
+#include <mutex>
 #include "bundle_base.h"
 #include "bundle.h"
 #include "transcript.h"
 #include "splice_graph.h"
+#include "thread_pool.h"
 
 using namespace std;
 
 class assembler
 {
 public:
-	assembler();
+	assembler(htsThreadPool *tp);
+	assembler(htsThreadPool *tp, hts_idx_t *x, int tid, int32_t beg, int32_t end);	// a shard assembling [beg, end) of chromosome tid
 	~assembler();
 
 private:
 	samFile *sfn;
 	bam_hdr_t *hdr;
 	bam1_t *b1t;
+	htsThreadPool *hpool;	// decompression threads, shared with the shards
+	hts_idx_t *idx;			// index of the input, loaded only if shards can run concurrently
+	hts_itr_t *itr;			// iterator of a shard, NULL if reading through the whole file
+	int32_t rbeg;			// hits starting before rbeg belong to the previous shard
+	double rtime;			// seconds spent in sam_read1, i.e., decompressing and parsing
 	bundle_base bb1;		// +
 	bundle_base bb2;		// -
-	vector<bundle_base> pool;
+	deque<bundle_base> pool;				// bundles are moved in; a deque never relocates them
+	thread_pool *tpool;						// workers for bundles, NULL if single-threaded
+	thread_pool *rpool;						// workers big bundles share for their regions, NULL if none
 
 	int index;
+	int nskip;								// bundles skipped as unable to yield a transcript
+	int merged;								// index of the next bundle to append to trsts
 	bool terminate;
 	int qcnt;
 	double qlen;
 	vector<transcript> trsts;
+	map< int, vector<transcript> > pending;	// finished bundles waiting for earlier ones
+	mutex mtx;								// protects merged, trsts and pending
+	vector< pair<int, PI32> > ranges;		// chromosome and [begin, end) of each shard
+	vector<assembler*> shards;				// finished shards, in the order of ranges
 
 public:
 	int assemble();
 
 private:
+	int open(htsThreadPool *tp);
+	int close();
+	int read();
+	int assemble_hits();
+	int assemble_shards();
+	int assemble_shard(int k);
+	int plan_shards();
+	int32_t find_gap(int tid, int32_t p, int32_t end);
+	int renumber(vector<transcript> &v, int x);
 	int process(int n);
-	int assemble(const splice_graph &gr, const hyper_set &hs);
+	int assemble_bundle(bundle_base &bb, int k);
+	int assemble(splice_graph &&gr, hyper_set &&hs, int k, int &g, vector<transcript> &v);
+	int collect(int k, vector<transcript> &v);
 	int assign_RPKM();
 	int write();
 	int compare(splice_graph &gr, const string &ref, const string &tex = "");
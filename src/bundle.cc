@@ -16,9 +16,10 @@ See LICENSE for licensing.
 #include "util.h"
 #include "undirected_graph.h"
 
-bundle::bundle(const bundle_base &bb)
-	: bundle_base(bb)
+bundle::bundle(bundle_base &&bb)
+	: bundle_base(std::move(bb))
 {
+	tpool = NULL;
 }
 
 bundle::~bundle()
@@ -26,6 +27,10 @@ bundle::~bundle()
 
 int bundle::build()
 {
+	add_coverage();
+	mmap.build();
+	imap.build();
+
 	compute_strand();
 
 	check_left_ascending();
@@ -42,7 +47,8 @@ int bundle::build()
 
 	revise_splice_graph();
 
-	build_hyper_edges2();
+	if(streaming_bundles == true) build_hyper_edges3();
+	else build_hyper_edges2();
 
 	return 0;
 }
@@ -52,14 +58,6 @@ int bundle::compute_strand()
 	if(library_type != UNSTRANDED) assert(strand != '.');
 	if(library_type != UNSTRANDED) return 0;
 
-	int n0 = 0, np = 0, nq = 0;
-	for(int i = 0; i < hits.size(); i++)
-	{
-		if(hits[i].xs == '.') n0++;
-		if(hits[i].xs == '+') np++;
-		if(hits[i].xs == '-') nq++;
-	}
-
 	if(np > nq) strand = '+';
 	else if(np < nq) strand = '-';
 	else strand = '.';
@@ -91,83 +89,42 @@ int bundle::check_right_ascending()
 
 int bundle::build_junctions()
 {
-	int min_max_boundary_quality = min_mapping_quality;
-	map< int64_t, vector<int> > m;
+	// with streaming_bundles the junctions are counted as hits arrive
 	for(int i = 0; i < hits.size(); i++)
 	{
-		vector<int64_t> v = hits[i].spos;
-		if(v.size() == 0) continue;
-
-		//hits[i].print();
-		for(int k = 0; k < v.size(); k++)
-		{
-			int64_t p = v[k];
-
-			// DEBUG
-			/*
-			int32_t x1 = low32(p);
-			int32_t x2 = high32(p);
-			if(fabs(x1 - 9364768) <= 2 || fabs(x2 - 9364768) <=2)
-			{
-				printf("HIT ");
-				hits[i].print();
-			}
-			*/
-			if(m.find(p) == m.end())
-			{
-				vector<int> hv;
-				hv.push_back(i);
-				m.insert(pair< int64_t, vector<int> >(p, hv));
-			}
-			else
-			{
-				m[p].push_back(i);
-			}
-		}
+		const hit &h = hits[i];
+		if(h.n_spos == 0) continue;
+		add_junctions(h, h.spos, h.n_spos);
 	}
 
-	map< int64_t, vector<int> >::iterator it;
-	for(it = m.begin(); it != m.end(); it++)
-	{
-		vector<int> &v = it->second;
-		if(v.size() < min_splice_boundary_hits) continue;
+	merge_junctions();
 
-		int32_t p1 = high32(it->first);
-		int32_t p2 = low32(it->first);
+	// entries of a junction differ only in xs, which votes for its strand
+	for(int i = 0; i < jstat.size(); )
+	{
+		junction jc = jstat[i];
+		jc.count = jc.nm = 0;
 
-		int s0 = 0;
 		int s1 = 0;
 		int s2 = 0;
-		int nm = 0;
-		for(int k = 0; k < v.size(); k++)
+		for(; i < jstat.size() && jstat[i].lpos == jc.lpos && jstat[i].rpos == jc.rpos; i++)
 		{
-			hit &h = hits[v[k]];
-			nm += h.nm;
-			if(h.xs == '.') s0++;
-			if(h.xs == '+') s1++;
-			if(h.xs == '-') s2++;
+			const junction &x = jstat[i];
+			jc.count += x.count;
+			jc.nm += x.nm;
+			if(x.strand == '+') s1 += x.count;
+			if(x.strand == '-') s2 += x.count;
 		}
 
-		//printf("junction: %s:%d-%d (%d, %d, %d) %d\n", chrm.c_str(), p1, p2, s0, s1, s2, s1 < s2 ? s1 : s2);
+		if(jc.count < min_splice_boundary_hits) continue;
 
-		junction jc(it->first, v.size());
-		jc.nm = nm;
 		if(s1 == 0 && s2 == 0) jc.strand = '.';
 		else if(s1 >= 1 && s2 >= 1) jc.strand = '.';
 		else if(s1 > s2) jc.strand = '+';
 		else jc.strand = '-';
 		junctions.push_back(jc);
-
-		/*
-		uint32_t max_qual = 0;
-		for(int k = 0; k < v.size(); k++)
-		{
-			hit &h = hits[v[k]];
-			if(h.qual > max_qual) max_qual = h.qual;
-		}
-		assert(max_qual >= min_max_boundary_quality);
-		*/
 	}
+	jstat.clear();
 	return 0;
 }
 
@@ -195,11 +152,11 @@ int bundle::correct_junctions()
 			// correct nm2 to nm1
 			fb.insert(k);
 
-			if(j1.lpos < j2.lpos) mmap += make_pair(ROI(j1.lpos + 1, j2.lpos + 1), -1);
-			else if(j1.lpos > j2.lpos) mmap += make_pair(ROI(j2.lpos + 1, j1.lpos + 1), 1);
+			if(j1.lpos < j2.lpos) mmap.add(j1.lpos + 1, j2.lpos + 1, -1);
+			else if(j1.lpos > j2.lpos) mmap.add(j2.lpos + 1, j1.lpos + 1, 1);
 
-			if(j1.rpos < j2.rpos) mmap += make_pair(ROI(j1.rpos, j2.rpos), 1);
-			else if(j1.rpos > j2.rpos) mmap += make_pair(ROI(j2.rpos, j1.rpos), -1);
+			if(j1.rpos < j2.rpos) mmap.add(j1.rpos, j2.rpos, 1);
+			else if(j1.rpos > j2.rpos) mmap.add(j2.rpos, j1.rpos, -1);
 
 			if(verbose >= 2)
 			{
@@ -211,11 +168,11 @@ int bundle::correct_junctions()
 		{
 			// correct nm1 to nm2
 			fb.insert(k - 1);
-			if(j2.lpos < j1.lpos) mmap += make_pair(ROI(j2.lpos + 1, j1.lpos + 1), -1);
-			else if(j2.lpos > j1.lpos) mmap += make_pair(ROI(j1.lpos + 1, j2.lpos + 1), 1);
+			if(j2.lpos < j1.lpos) mmap.add(j2.lpos + 1, j1.lpos + 1, -1);
+			else if(j2.lpos > j1.lpos) mmap.add(j1.lpos + 1, j2.lpos + 1, 1);
 
-			if(j2.rpos < j1.rpos) mmap += make_pair(ROI(j2.rpos, j1.rpos), 1);
-			else if(j2.rpos > j1.rpos) mmap += make_pair(ROI(j1.rpos, j2.rpos), -1);
+			if(j2.rpos < j1.rpos) mmap.add(j2.rpos, j1.rpos, 1);
+			else if(j2.rpos > j1.rpos) mmap.add(j1.rpos, j2.rpos, -1);
 
 			if(verbose >= 2)
 			{
@@ -224,6 +181,7 @@ int bundle::correct_junctions()
 			}
 		}
 	}
+	mmap.build();
 
 	vector<junction> v;
 	for(int i = 0; i < junctions.size(); i++)
@@ -268,7 +226,33 @@ int bundle::build_regions()
 	sort(v.begin(), v.end());
 
 	regions.clear();
-	for(int k = 0; k < v.size() - 1; k++)
+	int n = v.size() - 1;
+	if(tpool == NULL || n < min_parallel_regions)
+	{
+		add_regions(v, 0, n, regions);
+		return 0;
+	}
+
+	// regions only read the coverage, so chunks of them are built
+	// on the shared workers and concatenated in order
+	int m = 4 * tpool->size();
+	vector< vector<region> > vr(m);
+	tpool->run(m, [this, &v, &vr, n, m](int i)
+	{
+		add_regions(v, (int64_t)(n) * i / m, (int64_t)(n) * (i + 1) / m, vr[i]);
+	});
+
+	for(int i = 0; i < m; i++)
+	{
+		regions.insert(regions.end(), vr[i].begin(), vr[i].end());
+	}
+	return 0;
+}
+
+int bundle::add_regions(const vector<PPI> &v, int a, int b, vector<region> &rs) const
+{
+	// region k lies between the k-th and (k + 1)-th boundaries in v
+	for(int k = a; k < b; k++)
 	{
 		int32_t l = v[k].first;
 		int32_t r = v[k + 1].first;
@@ -278,9 +262,8 @@ int bundle::build_regions()
 		if(ltype == LEFT_RIGHT_SPLICE) ltype = RIGHT_SPLICE;
 		if(rtype == LEFT_RIGHT_SPLICE) rtype = LEFT_SPLICE;
 
-		regions.push_back(region(l, r, ltype, rtype, &mmap, &imap));
+		rs.push_back(region(l, r, ltype, rtype, &mmap, &imap));
 	}
-
 	return 0;
 }
 
@@ -301,21 +284,28 @@ int bundle::build_partial_exon_map()
 	for(int i = 0; i < pexons.size(); i++)
 	{
 		partial_exon &p = pexons[i];
-		pmap += make_pair(ROI(p.lpos, p.rpos), i + 1);
+		if(i >= 1) assert(pexons[i - 1].rpos <= p.lpos);
+		pmap.push_back(PI32(p.lpos, p.rpos));
 	}
 	return 0;
 }
 
-int bundle::locate_left_partial_exon(int32_t x)
+int bundle::locate_partial_exon(int32_t x, int s) const
 {
-	SIMI it = pmap.find(ROI(x, x + 1));
-	if(it == pmap.end()) return -1;
-	assert(it->second >= 1);
-	assert(it->second <= pexons.size());
-
-	int k = it->second - 1;
-	int32_t p1 = lower(it->first);
-	int32_t p2 = upper(it->first);
+	// the partial exon containing x, searched from the s-th one
+	int k = upper_bound(pmap.begin() + s, pmap.end(), PI32(x, INT32_MAX)) - pmap.begin() - 1;
+	if(k < s || pmap[k].second <= x) return -1;
+	return k;
+}
+
+int bundle::locate_left_partial_exon(int32_t x, int &s) const
+{
+	int k = locate_partial_exon(x, s);
+	if(k == -1) return -1;
+	s = k;
+
+	int32_t p1 = pmap[k].first;
+	int32_t p2 = pmap[k].second;
 	assert(p2 >= x);
 	assert(p1 <= x);
 
@@ -325,16 +315,14 @@ int bundle::locate_left_partial_exon(int32_t x)
 	return k;
 }
 
-int bundle::locate_right_partial_exon(int32_t x)
+int bundle::locate_right_partial_exon(int32_t x, int &s) const
 {
-	SIMI it = pmap.find(ROI(x - 1, x));
-	if(it == pmap.end()) return -1;
-	assert(it->second >= 1);
-	assert(it->second <= pexons.size());
-
-	int k = it->second - 1;
-	int32_t p1 = lower(it->first);
-	int32_t p2 = upper(it->first);
+	int k = locate_partial_exon(x - 1, s);
+	if(k == -1) return -1;
+	s = k;
+
+	int32_t p1 = pmap[k].first;
+	int32_t p2 = pmap[k].second;
 	assert(p1 < x);
 	assert(p2 >= x);
 
@@ -342,6 +330,25 @@ int bundle::locate_right_partial_exon(int32_t x)
 	return k;
 }
 
+int bundle::locate_partial_exons(const vector<int64_t> &v, vector<int> &sp) const
+{
+	// the intervals in v are ascending, so each search starts
+	// from the partial exon found for the previous position
+	int s = 0;
+	for(int k = 0; k < v.size(); k++)
+	{
+		int32_t p1 = high32(v[k]);
+		int32_t p2 = low32(v[k]);
+
+		int k1 = locate_left_partial_exon(p1, s);
+		int k2 = locate_right_partial_exon(p2, s);
+		if(k1 < 0 || k2 < 0) continue;
+
+		for(int j = k1; j <= k2; j++) sp.push_back(j);
+	}
+	return 0;
+}
+
 int bundle::build_hyper_edges1()
 {
 	hs.clear();
@@ -354,21 +361,12 @@ int bundle::build_hyper_edges1()
 		h.get_matched_intervals(v);
 		if(v.size() == 0) continue;
 
-		set<int> sp;
-		for(int k = 0; k < v.size(); k++)
-		{
-			int32_t p1 = high32(v[k]);
-			int32_t p2 = low32(v[k]);
-
-			int k1 = locate_left_partial_exon(p1);
-			int k2 = locate_right_partial_exon(p2);
-			if(k1 < 0 || k2 < 0) continue;
-
-			for(int j = k1; j <= k2; j++) sp.insert(j);
-		}
+		vector<int> u;
+		locate_partial_exons(v, u);
 
+		set<int> sp(u.begin(), u.end());
 		if(sp.size() <= 1) continue;
-		hs.add_node_list(sp);
+		hs.add_node_list(sp, h.weight);
 	}
 
 	return 0;
@@ -376,8 +374,15 @@ int bundle::build_hyper_edges1()
 
 int bundle::build_hyper_edges2()
 {
-	//sort(hits.begin(), hits.end(), hit_compare_by_name);
-	sort(hits.begin(), hits.end());
+	// group the hits of a fragment by sorting (hash of query name, index)
+	// keys, leaving the hits in place; equal hashes fall back to hit::operator<
+	vector< pair<uint64_t, int> > ix(hits.size());
+	for(int i = 0; i < hits.size(); i++) ix[i] = pair<uint64_t, int>(hits[i].qhash, i);
+	sort(ix.begin(), ix.end(), [this](const pair<uint64_t, int> &x, const pair<uint64_t, int> &y)
+	{
+		if(x.first != y.first) return x.first < y.first;
+		return hits[x.second] < hits[y.second];
+	});
 
 	/*
 	printf("----------------------\n");
@@ -387,12 +392,14 @@ int bundle::build_hyper_edges2()
 
 	hs.clear();
 
-	string qname;
+	uint64_t qhash = 0;
+	const char *qname = NULL;
 	int hi = -2;
+	int w = 1;
 	vector<int> sp1;
-	for(int i = 0; i < hits.size(); i++)
+	for(int i = 0; i < ix.size(); i++)
 	{
-		hit &h = hits[i];
+		const hit &h = hits[ix[i].second];
 		
 		/*
 		printf("sp1 = ( ");
@@ -401,13 +408,16 @@ int bundle::build_hyper_edges2()
 		h.print();
 		*/
 
-		if(h.qname != qname || h.hi != hi)
+		if(qname == NULL || h.qhash != qhash || strcmp(h.qname, qname) != 0 || h.hi != hi)
 		{
 			set<int> s(sp1.begin(), sp1.end());
-			if(s.size() >= 2) hs.add_node_list(s);
+			if(s.size() >= 2) hs.add_node_list(s, w);
 			sp1.clear();
 		}
 
+		// a collapsed hit forms a group on its own
+		w = h.weight;
+		qhash = h.qhash;
 		qname = h.qname;
 		hi = h.hi;
 
@@ -415,62 +425,83 @@ int bundle::build_hyper_edges2()
 
 		vector<int64_t> v;
 		h.get_matched_intervals(v);
+		phase_hit(sp1, v, h.isize < 0, w);
+	}
 
-		vector<int> sp2;
-		for(int k = 0; k < v.size(); k++)
-		{
-			int32_t p1 = high32(v[k]);
-			int32_t p2 = low32(v[k]);
+	return 0;
+}
 
-			int k1 = locate_left_partial_exon(p1);
-			int k2 = locate_right_partial_exon(p2);
-			if(k1 < 0 || k2 < 0) continue;
+int bundle::build_hyper_edges3()
+{
+	// the fragments collected while streaming, with
+	// identical ones merged, in place of the sorted hits
+	mates.flush();
+	hs.clear();
 
-			for(int j = k1; j <= k2; j++) sp2.push_back(j);
-		}
+	MVLI::iterator it;
+	for(it = mates.phases.begin(); it != mates.phases.end(); it++)
+	{
+		const vector<int64_t> &sig = it->first;
+		int c = it->second;
 
-		if(sp1.size() <= 0 || sp2.size() <= 0)
+		vector<int> sp1;
+		for(int k = 0; k < sig.size(); )
 		{
-			sp1.insert(sp1.end(), sp2.begin(), sp2.end());
-			continue;
+			int n = high32(sig[k]);
+			bool b = (low32(sig[k]) == 1);
+			vector<int64_t> v(sig.begin() + k + 1, sig.begin() + k + 1 + n);
+			phase_hit(sp1, v, b, c);
+			k += n + 1;
 		}
 
-		/*
-		printf("sp2 = ( ");
-		printv(sp2);
-		printf(")\n");
-		*/
+		set<int> s(sp1.begin(), sp1.end());
+		if(s.size() >= 2) hs.add_node_list(s, c);
+	}
+	mates.clear();
 
-		int x1 = -1, x2 = -1;
-		if(h.isize < 0) 
-		{
-			x1 = sp1[max_element(sp1)];
-			x2 = sp2[min_element(sp2)];
-		}
-		else
-		{
-			x1 = sp2[max_element(sp2)];
-			x2 = sp1[min_element(sp1)];
-		}
+	return 0;
+}
 
-		vector<int> sp3;
-		bool c = bridge_read(x1, x2, sp3);
+int bundle::phase_hit(vector<int> &sp1, const vector<int64_t> &v, bool b, int c)
+{
+	// sp1 lists the partial exons of the previous hits of a fragment;
+	// extend it with the hit whose matched intervals are v (b: isize < 0),
+	// or emit it as a hyper-edge of weight c if the two cannot be bridged
+	vector<int> sp2;
+	locate_partial_exons(v, sp2);
 
-		//printf("=========\n");
+	if(sp1.size() <= 0 || sp2.size() <= 0)
+	{
+		sp1.insert(sp1.end(), sp2.begin(), sp2.end());
+		return 0;
+	}
 
-		if(c == false)
-		{
-			set<int> s(sp1.begin(), sp1.end());
-			if(s.size() >= 2) hs.add_node_list(s);
-			sp1 = sp2;
-		}
-		else
-		{
-			sp1.insert(sp1.end(), sp2.begin(), sp2.end());
-			sp1.insert(sp1.end(), sp3.begin(), sp3.end());
-		}
+	int x1 = -1, x2 = -1;
+	if(b == true) 
+	{
+		x1 = sp1[max_element(sp1)];
+		x2 = sp2[min_element(sp2)];
+	}
+	else
+	{
+		x1 = sp2[max_element(sp2)];
+		x2 = sp1[min_element(sp1)];
 	}
 
+	vector<int> sp3;
+	bool bridged = bridge_read(x1, x2, sp3);
+
+	if(bridged == false)
+	{
+		set<int> s(sp1.begin(), sp1.end());
+		if(s.size() >= 2) hs.add_node_list(s, c);
+		sp1 = sp2;
+	}
+	else
+	{
+		sp1.insert(sp1.end(), sp2.begin(), sp2.end());
+		sp1.insert(sp1.end(), sp3.begin(), sp3.end());
+	}
 	return 0;
 }
 
@@ -684,6 +715,12 @@ int bundle::build_splice_graph()
 
 int bundle::revise_splice_graph()
 {
+	// each step revisits only what changed since it last changed nothing,
+	// which keeps the restarts after every modification cheap
+	touched.clear();
+	rmarks.assign(7, -1);
+	rsaved = 0;
+
 	while(true)
 	{
 		bool b = false;
@@ -714,32 +751,115 @@ int bundle::revise_splice_graph()
 
 	refine_splice_graph();
 
+	if(verbose >= 2) printf("revise splice graph: %d vertex visits saved\n", rsaved);
+
 	return 0;
 }
 
 int bundle::refine_splice_graph()
 {
-	while(true)
+	// clearing a vertex may leave its neighbors without in- or out-edges
+	set<int> sv;
+	int m = revisit_vertices(6, 0, sv);
+	while(sv.size() >= 1)
 	{
-		bool b = false;
-		for(int i = 1; i < gr.num_vertices() - 1; i++)
+		int i = *sv.begin();
+		sv.erase(sv.begin());
+		if(gr.degree(i) == 0) continue;
+		if(gr.in_degree(i) >= 1 && gr.out_degree(i) >= 1) continue;
+		clear_touched_vertex(i);
+		m = touched_vertices(m, 0, sv);
+	}
+	rmarks[6] = touched.size();
+	return 0;
+}
+
+int bundle::touched_vertices(int p, int r, set<int> &sv)
+{
+	// add to sv the vertices touched since position p of the log, with
+	// their neighbors if r is 1, or all vertices if p is -1; the steps
+	// check nothing beyond a vertex and its neighbors, so this covers
+	// whatever they could find since the log had p entries
+	int n = gr.num_vertices() - 1;
+	if(p == -1)
+	{
+		for(int i = 1; i < n; i++) sv.insert(i);
+		return touched.size();
+	}
+
+	for(int j = p; j < touched.size(); j++)
+	{
+		int v = touched[j];
+		sv.insert(v);
+		if(r == 0) continue;
+
+		edge_iterator it1, it2;
+		for(tie(it1, it2) = gr.in_edges(v); it1 != it2; it1++)
 		{
-			if(gr.degree(i) == 0) continue;
-			if(gr.in_degree(i) >= 1 && gr.out_degree(i) >= 1) continue;
-			gr.clear_vertex(i);
-			b = true;
+			int s = (*it1)->source();
+			if(s != 0) sv.insert(s);
+		}
+		for(tie(it1, it2) = gr.out_edges(v); it1 != it2; it1++)
+		{
+			int t = (*it1)->target();
+			if(t != n) sv.insert(t);
 		}
-		if(b == false) break;
 	}
+
+	return touched.size();
+}
+
+int bundle::revisit_vertices(int k, int r, set<int> &sv)
+{
+	// the vertices that step k has to look at again
+	int p = touched_vertices(rmarks[k], r, sv);
+	rsaved += gr.num_vertices() - 2 - sv.size();
+	return p;
+}
+
+int bundle::touch_vertex(int v)
+{
+	// the degrees of the source and the sink are never tested
+	if(v == 0 || v == gr.num_vertices() - 1) return 0;
+	touched.push_back(v);
+	return 0;
+}
+
+int bundle::clear_touched_vertex(int v)
+{
+	edge_iterator it1, it2;
+	for(tie(it1, it2) = gr.in_edges(v); it1 != it2; it1++) touch_vertex((*it1)->source());
+	for(tie(it1, it2) = gr.out_edges(v); it1 != it2; it1++) touch_vertex((*it1)->target());
+	touch_vertex(v);
+	gr.clear_vertex(v);
+	return 0;
+}
+
+int bundle::remove_touched_edge(edge_descriptor e)
+{
+	touch_vertex(e->source());
+	touch_vertex(e->target());
+	gr.remove_edge(e);
 	return 0;
 }
 
 bool bundle::extend_boundaries()
 {
+	// the edges at touched vertices, in the order of gr.edges()
+	set<int> sv;
+	revisit_vertices(0, 0, sv);
+
+	SE se;
 	edge_iterator it1, it2;
-	for(tie(it1, it2) = gr.edges(); it1 != it2; it1++)
+	for(set<int>::iterator x = sv.begin(); x != sv.end(); x++)
 	{
-		edge_descriptor e = (*it1);
+		for(tie(it1, it2) = gr.in_edges(*x); it1 != it2; it1++) se.insert(*it1);
+		for(tie(it1, it2) = gr.out_edges(*x); it1 != it2; it1++) se.insert(*it1);
+	}
+
+	for(SE::iterator it = se.begin(); it != se.end(); it++)
+	{
+		edge_descriptor e = (*it);
 		int s = e->source();
 		int t = e->target();
 		int32_t p = gr.get_vertex_info(t).lpos - gr.get_vertex_info(s).rpos;
@@ -770,11 +890,12 @@ bool bundle::extend_boundaries()
 			gr.set_edge_info(ee, edge_info());
 		}
 
-		gr.remove_edge(e);
+		remove_touched_edge(e);
 
 		return true;
 	}
 
+	rmarks[0] = touched.size();
 	return false;
 }
 
@@ -800,7 +921,12 @@ VE bundle::compute_maximal_edges()
 
 	vector<int> vv = ug.assign_connected_components();
 
-	sort(ve.begin(), ve.end());
+	// equal weights are ordered by creation, not by address
+	sort(ve.begin(), ve.end(), [](const PDE &x, const PDE &y)
+	{
+		if(x.first != y.first) return x.first < y.first;
+		return edge_cmp()(x.second, y.second);
+	});
 
 	for(int i = 1; i < ve.size(); i++) assert(ve[i - 1].first <= ve[i].first);
 
@@ -896,7 +1022,7 @@ bool bundle::keep_surviving_edges()
 	for(int i = 0; i < ve.size(); i++)
 	{
 		if(verbose >= 2) printf("remove edge (%d, %d), weight = %.2lf\n", ve[i]->source(), ve[i]->target(), gr.get_edge_weight(ve[i]));
-		gr.remove_edge(ve[i]);
+		remove_touched_edge(ve[i]);
 	}
 
 	if(ve.size() >= 1) return true;
@@ -906,8 +1032,11 @@ bool bundle::keep_surviving_edges()
 bool bundle::remove_small_exons()
 {
 	bool flag = false;
-	for(int i = 1; i < gr.num_vertices() - 1; i++)
+	set<int> sv;
+	int m = revisit_vertices(2, 0, sv);
+	for(set<int>::iterator x = sv.begin(); x != sv.end(); x++)
 	{
+		int i = *x;
 		bool b = true;
 		edge_iterator it1, it2;
 		int32_t p1 = gr.get_vertex_info(i).lpos;
@@ -938,17 +1067,22 @@ bool bundle::remove_small_exons()
 		// only consider boundary small exons
 		if(gr.edge(0, i).second == false && gr.edge(i, gr.num_vertices() - 1).second == false) continue;
 
-		gr.clear_vertex(i);
+		clear_touched_vertex(i);
+		m = touched_vertices(m, 0, sv);
 		flag = true;
 	}
+	if(flag == false) rmarks[2] = touched.size();
 	return flag;
 }
 
 bool bundle::remove_small_junctions()
 {
 	SE se;
-	for(int i = 1; i < gr.num_vertices() - 1; i++)
+	set<int> sv;
+	revisit_vertices(3, 0, sv);
+	for(set<int>::iterator x = sv.begin(); x != sv.end(); x++)
 	{
+		int i = *x;
 		if(gr.degree(i) <= 0) continue;
 
 		bool b = true;
@@ -1013,12 +1147,13 @@ bool bundle::remove_small_junctions()
 
 	}
 
+	if(se.size() <= 0) rmarks[3] = touched.size();
 	if(se.size() <= 0) return false;
 
 	for(SE::iterator it = se.begin(); it != se.end(); it++)
 	{
 		edge_descriptor e = (*it);
-		gr.remove_edge(e);
+		remove_touched_edge(e);
 	}
 
 	return true;
@@ -1028,8 +1163,11 @@ bool bundle::remove_inner_boundaries()
 {
 	bool flag = false;
 	int n = gr.num_vertices() - 1;
-	for(int i = 1; i < gr.num_vertices() - 1; i++)
+	set<int> sv;
+	int m = revisit_vertices(1, 1, sv);
+	for(set<int>::iterator x = sv.begin(); x != sv.end(); x++)
 	{
+		int i = *x;
 		if(gr.in_degree(i) != 1) continue;
 		if(gr.out_degree(i) != 1) continue;
 
@@ -1038,7 +1176,7 @@ bool bundle::remove_inner_boundaries()
 		edge_descriptor e1 = (*it1);
 		tie(it1, it2) = gr.out_edges(i);
 		edge_descriptor e2 = (*it1);
-		vertex_info vi = gr.get_vertex_info(i);
+		const vertex_info &vi = gr.get_vertex_info(i);
 		int s = e1->source();
 		int t = e2->target();
 
@@ -1051,17 +1189,22 @@ bool bundle::remove_inner_boundaries()
 		if(verbose >= 2) printf("remove inner boundary: vertex = %d, weight = %.2lf, length = %d, pos = %d-%d\n",
 				i, gr.get_vertex_weight(i), vi.length, vi.lpos, vi.rpos);
 
-		gr.clear_vertex(i);
+		clear_touched_vertex(i);
+		m = touched_vertices(m, 1, sv);
 		flag = true;
 	}
+	if(flag == false) rmarks[1] = touched.size();
 	return flag;
 }
 
 bool bundle::remove_intron_contamination()
 {
 	bool flag = false;
-	for(int i = 1; i < gr.num_vertices(); i++)
+	set<int> sv;
+	int m = revisit_vertices(5, 1, sv);
+	for(set<int>::iterator x = sv.begin(); x != sv.end(); x++)
 	{
+		int i = *x;
 		if(gr.in_degree(i) != 1) continue;
 		if(gr.out_degree(i) != 1) continue;
 
@@ -1073,7 +1216,7 @@ bool bundle::remove_intron_contamination()
 		int s = e1->source();
 		int t = e2->target();
 		double wv = gr.get_vertex_weight(i);
-		vertex_info vi = gr.get_vertex_info(i);
+		const vertex_info &vi = gr.get_vertex_info(i);
 
 		if(s == 0) continue;
 		if(t == gr.num_vertices() - 1) continue;
@@ -1091,9 +1234,11 @@ bool bundle::remove_intron_contamination()
 
 		if(verbose >= 2) printf("clear intron contamination %d, weight = %.2lf, length = %d, edge weight = %.2lf\n", i, wv, vi.length, we);
 
-		gr.clear_vertex(i);
+		clear_touched_vertex(i);
+		m = touched_vertices(m, 1, sv);
 		flag = true;
 	}
+	if(flag == false) rmarks[5] = touched.size();
 	return flag;
 }
 
@@ -1112,17 +1257,8 @@ int bundle::print(int index)
 {
 	printf("Bundle %d: ", index);
 
-	// statistic xs
-	int n0 = 0, np = 0, nq = 0;
-	for(int i = 0; i < hits.size(); i++)
-	{
-		if(hits[i].xs == '.') n0++;
-		if(hits[i].xs == '+') np++;
-		if(hits[i].xs == '-') nq++;
-	}
-
-	printf("tid = %d, #hits = %lu, #partial-exons = %lu, range = %s:%d-%d, orient = %c (%d, %d, %d)\n",
-			tid, hits.size(), pexons.size(), chrm.c_str(), lpos, rpos, strand, n0, np, nq);
+	printf("tid = %d, #hits = %d, #partial-exons = %lu, range = %s:%d-%d, orient = %c (%d, %d, %d)\n",
+			tid, nhits, pexons.size(), chrm.c_str(), lpos, rpos, strand, n0, np, nq);
 
 	if(verbose <= 1) return 0;
 
@@ -17,22 +17,27 @@ See LICENSE for licensing.
 #include "path.h"
 #include "gene.h"
 #include "transcript.h"
+#include "thread_pool.h"
 
 using namespace std;
 
 class bundle : public bundle_base
 {
 public:
-	bundle(const bundle_base &bb);
+	bundle(bundle_base &&bb);
 	virtual ~bundle();
 
 public:
 	vector<junction> junctions;		// splice junctions
 	vector<region> regions;			// regions
 	vector<partial_exon> pexons;	// partial exons
-	split_interval_map pmap;		// partial exon map
+	vector<PI32> pmap;				// boundaries of partial exons, sorted
 	splice_graph gr;				// splice graph
 	hyper_set hs;					// hyper edges
+	thread_pool *tpool;				// workers to share for the regions of a big bundle, NULL if none
+	vector<int> touched;			// vertices whose edges changed while revising the splice graph
+	vector<int> rmarks;				// size of touched when each revising step last changed nothing
+	int rsaved;						// vertex visits saved by looking only at touched vertices
 
 public:
 	virtual int build();
@@ -54,12 +59,15 @@ private:
 	int build_junctions();
 	int correct_junctions();
 	int build_regions();
+	int add_regions(const vector<PPI> &v, int a, int b, vector<region> &rs) const;
 	int build_partial_exons();
 	int link_partial_exons();
 	int build_splice_graph();
 	int build_partial_exon_map();
-	int locate_left_partial_exon(int32_t x);
-	int locate_right_partial_exon(int32_t x);
+	int locate_partial_exon(int32_t x, int s) const;
+	int locate_left_partial_exon(int32_t x, int &s) const;
+	int locate_right_partial_exon(int32_t x, int &s) const;
+	int locate_partial_exons(const vector<int64_t> &v, vector<int> &sp) const;
 
 	// revise splice graph
 	VE compute_maximal_edges();
@@ -71,10 +79,17 @@ private:
 	bool remove_small_exons();
 	bool remove_inner_boundaries();
 	bool remove_intron_contamination();
+	int touched_vertices(int p, int r, set<int> &sv);
+	int revisit_vertices(int k, int r, set<int> &sv);
+	int touch_vertex(int v);
+	int clear_touched_vertex(int v);
+	int remove_touched_edge(edge_descriptor e);
 
 	// super edges
 	int build_hyper_edges1();			// single end
-	int build_hyper_edges2();			// paired end
+	int build_hyper_edges2();
+	int build_hyper_edges3();			// from fragments, with streaming_bundles
+	int phase_hit(vector<int> &sp1, const vector<int64_t> &v, bool b, int c);			// paired end
 	bool bridge_read(int x, int y, vector<int> &s);
 
 };
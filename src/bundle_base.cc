@@ -7,6 +7,7 @@ See LICENSE for licensing.
 #include <cassert>
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
 
 #include "bundle_base.h"
 
@@ -17,6 +18,10 @@ bundle_base::bundle_base()
 	lpos = INT32_MAX;
 	rpos = 0;
 	strand = '.';
+	nhits = 0;
+	n0 = np = nq = 0;
+	jmax = 1024;
+	cpos = -1;
 }
 
 bundle_base::~bundle_base()
@@ -24,8 +29,10 @@ bundle_base::~bundle_base()
 
 int bundle_base::add_hit(const hit &ht)
 {
-	// store new hit
-	hits.push_back(ht);
+	nhits++;
+	if(ht.xs == '.') n0++;
+	if(ht.xs == '+') np++;
+	if(ht.xs == '-') nq++;
 
 	// calcuate the boundaries on reference
 	if(ht.pos < lpos) lpos = ht.pos;
@@ -36,7 +43,7 @@ int bundle_base::add_hit(const hit &ht)
 	assert(tid == ht.tid);
 
 	// set strand
-	if(hits.size() <= 1) strand = ht.strand;
+	if(nhits <= 1) strand = ht.strand;
 	assert(strand == ht.strand);
 
 	// DEBUG
@@ -47,45 +54,296 @@ int bundle_base::add_hit(const hit &ht)
 	}
 	*/
 
-	// add intervals
+	// hits are sorted, so identical alignments start at the same position
+	if(ht.pos != cpos)
+	{
+		add_coverage();
+		chits.clear();
+		cpos = ht.pos;
+	}
+
+	const uint32_t *cg = NULL;		// a copy of the cigar in hmem or cmem
+	int n = ht.get_splice_positions(NULL);
+	if(streaming_bundles == true)
+	{
+		// only junctions and fragments are kept
+		if(n >= 1)
+		{
+			vector<int64_t> v(n);
+			ht.get_splice_positions(v.data());
+			add_junctions(ht, v.data(), n);
+		}
+		mates.add_hit(ht);
+	}
+	else if(collapse_hit(ht) == false)
+	{
+		// store new hit, moving its variable-length fields into the arena
+		hits.push_back(ht);
+		hit &h = hits.back();
+		h.qname = hmem.copy(ht.qname, strlen(ht.qname) + 1);
+		h.cigar = hmem.copy(ht.cigar, ht.n_cigar);
+		h.n_spos = n;
+		h.spos = NULL;
+		if(n >= 1)
+		{
+			int64_t *v = (int64_t*)hmem.allocate(n * sizeof(int64_t));
+			ht.get_splice_positions(v);
+			h.spos = v;
+		}
+		if(collapsible(h) == true) chits.push_back(hits.size() - 1);
+		cg = h.cigar;
+	}
+
+	// coverage is added once for each distinct alignment, weighted
+	for(int k = 0; k < cover.size(); k++)
+	{
+		if(cover[k].same_alignment(ht) == false) continue;
+		cover[k].weight++;
+		return 0;
+	}
+
+	cover.push_back(ht);
+	if(cg == NULL) cg = cmem.copy(ht.cigar, ht.n_cigar);
+	cover.back().cigar = cg;
+	cover.back().qname = NULL;
+	return 0;
+}
+
+bool bundle_base::collapsible(const hit &ht) const
+{
+	// a single-end hit is a template on its own, unless it lacks HI and
+	// has other alignments that build_hyper_edges2 must group with it
+	if((ht.flag & 0x1) >= 1) return false;
+	if(ht.scattered() == true) return false;
+	return true;
+}
+
+bool bundle_base::collapse_hit(const hit &ht)
+{
+	if(collapsible(ht) == false) return false;
+	for(int k = 0; k < chits.size(); k++)
+	{
+		hit &h = hits[chits[k]];
+		if(h.same_alignment(ht) == false) continue;
+		if(h.xs != ht.xs || h.strand != ht.strand) continue;
+		h.weight++;
+		h.nm += ht.nm;
+		return true;
+	}
+	return false;
+}
+
+int bundle_base::add_coverage()
+{
 	vector<int64_t> vm;
 	vector<int64_t> vi;
 	vector<int64_t> vd;
-	ht.get_mid_intervals(vm, vi, vd);
+	for(int i = 0; i < cover.size(); i++)
+	{
+		const hit &h = cover[i];
+		int w = h.weight;
+		h.get_mid_intervals(vm, vi, vd);
+
+		for(int k = 0; k < vm.size(); k++)
+		{
+			int32_t s = high32(vm[k]);
+			int32_t t = low32(vm[k]);
+			mmap.add(s, t, w);
+		}
 
-	//ht.print();
-	for(int k = 0; k < vm.size(); k++)
+		for(int k = 0; k < vi.size(); k++)
+		{
+			int32_t s = high32(vi[k]);
+			int32_t t = low32(vi[k]);
+			imap.add(s, t, w);
+		}
+
+		for(int k = 0; k < vd.size(); k++)
+		{
+			int32_t s = high32(vd[k]);
+			int32_t t = low32(vd[k]);
+			imap.add(s, t, w);
+		}
+	}
+	cover.clear();
+	cmem.clear();
+	return 0;
+}
+
+int bundle_base::add_junctions(const hit &ht, const int64_t *v, int n)
+{
+	for(int k = 0; k < n; k++)
 	{
-		int32_t s = high32(vm[k]);
-		int32_t t = low32(vm[k]);
-		//printf(" add interval %d-%d\n", s, t);
-		mmap += make_pair(ROI(s, t), 1);
+		junction jc(v[k], ht.weight);
+		jc.nm = ht.nm;
+		jc.strand = ht.xs;
+		jstat.push_back(jc);
 	}
 
-	for(int k = 0; k < vi.size(); k++)
+	// merging from time to time bounds jstat by the number of distinct junctions
+	if(jstat.size() < jmax) return 0;
+	merge_junctions();
+	if(jmax < 2 * jstat.size()) jmax = 2 * jstat.size();
+	return 0;
+}
+
+int bundle_base::merge_junctions()
+{
+	// sum up the entries with the same position and xs
+	sort(jstat.begin(), jstat.end(), junction_cmp_position);
+
+	int n = 0;
+	for(int i = 0; i < jstat.size(); i++)
 	{
-		int32_t s = high32(vi[k]);
-		int32_t t = low32(vi[k]);
-		imap += make_pair(ROI(s, t), 1);
+		junction &x = jstat[i];
+		if(n >= 1 && junction_cmp_position(jstat[n - 1], x) == false)
+		{
+			jstat[n - 1].count += x.count;
+			jstat[n - 1].nm += x.nm;
+		}
+		else
+		{
+			jstat[n++] = x;
+		}
+	}
+	jstat.resize(n);
+	return 0;
+}
+
+int bundle_base::split(vector<bundle_base> &v)
+{
+	// move the pieces between deep coverage valleys into v,
+	// or the whole bundle if it has none
+	vector<int32_t> cuts;
+	if(streaming_bundles == false && split_valley_ratio > 0) find_valleys(cuts);
+
+	if(cuts.size() == 0)
+	{
+		v.push_back(std::move(*this));
+		return 0;
+	}
+
+	int n = v.size();
+	v.resize(n + cuts.size() + 1);
+	for(int j = n; j < v.size(); j++)
+	{
+		v[j].tid = tid;
+		v[j].chrm = chrm;
+		v[j].strand = strand;
 	}
 
-	for(int k = 0; k < vd.size(); k++)
+	// a hit goes to the piece where it starts
+	for(int i = 0; i < hits.size(); i++)
 	{
-		int32_t s = high32(vd[k]);
-		int32_t t = low32(vd[k]);
-		imap += make_pair(ROI(s, t), 1);
+		const hit &h = hits[i];
+		int j = upper_bound(cuts.begin(), cuts.end(), h.pos) - cuts.begin();
+		v[n + j].add_weighted_hit(h);
 	}
 
+	clear();
 	return 0;
 }
 
-bool bundle_base::overlap(const hit &ht) const
+bool bundle_base::hopeless() const
 {
-	if(mmap.find(ROI(ht.pos, ht.pos + 1)) != mmap.end()) return true;
-	if(mmap.find(ROI(ht.rpos - 1, ht.rpos)) != mmap.end()) return true;
+	// every exon of a transcript lies in [lpos, rpos), also after
+	// filter::join_single_exon_transcripts fills the gaps between them,
+	// so no transcript is long enough if even one exon spanning the
+	// whole bundle would fail filter::filter_length_coverage; coverage
+	// gives no such bound, as decomposition rebalances the weights;
+	// with a negative increase, more exons need less length, so the
+	// single exon is no lower bound and nothing is rejected
+	if(min_transcript_length_increase < 0) return false;
+	int32_t minl = min_transcript_length_base + min_transcript_length_increase;
+	if(rpos - lpos < minl) return true;
 	return false;
 }
 
+int bundle_base::find_valleys(vector<int32_t> &cuts)
+{
+	add_coverage();
+	mmap.build();
+	imap.build();
+
+	// no cut may separate a spliced hit from itself, or a hit from its mate
+	coverage links;
+	for(int i = 0; i < hits.size(); i++)
+	{
+		const hit &h = hits[i];
+		if(h.n_spos >= 1) links.add(h.pos + 1, h.rpos, 1);
+		if(h.mpos >= 0) links.add(min(h.pos, h.mpos) + 1, max(h.pos, h.mpos) + 1, 1);
+	}
+	links.build();
+
+	// highest coverage of the segments before and after each one
+	int n = mmap.size();
+	if(n <= 1) return 0;
+	vector<int32_t> pm(n, 0);
+	vector<int32_t> sm(n, 0);
+	for(int k = 1; k < n; k++) pm[k] = max(pm[k - 1], mmap.cov[k - 1]);
+	for(int k = n - 2; k >= 0; k--) sm[k] = max(sm[k + 1], mmap.cov[k + 1]);
+
+	// a cut is made before segment k, either at the uncovered gap in
+	// front of it or at the segment itself, at the lowest coverage
+	// of each run of deep enough positions
+	int32_t bp = -1;
+	int32_t bc = INT32_MAX;
+	for(int k = 1; k < n; k++)
+	{
+		int32_t c = mmap.cov[k];
+		double h = min(pm[k], sm[k]);
+		if(mmap.lpos[k] > mmap.rpos[k - 1])
+		{
+			c = 0;
+			h = min(pm[k], max(sm[k], mmap.cov[k]));
+		}
+
+		int32_t p = mmap.lpos[k];
+		if(c > split_valley_ratio * h)
+		{
+			if(bp >= 0) cuts.push_back(bp);
+			bp = -1;
+			bc = INT32_MAX;
+			continue;
+		}
+
+		if(links.find(p) != -1) continue;
+		if(c >= bc) continue;
+		bp = p;
+		bc = c;
+	}
+	if(bp >= 0) cuts.push_back(bp);
+
+	return 0;
+}
+
+int bundle_base::add_weighted_hit(const hit &ht)
+{
+	// ht stands for ht.weight identical hits, with their coverage
+	nhits += ht.weight;
+	if(ht.xs == '.') n0 += ht.weight;
+	if(ht.xs == '+') np += ht.weight;
+	if(ht.xs == '-') nq += ht.weight;
+
+	if(ht.pos < lpos) lpos = ht.pos;
+	if(ht.rpos > rpos) rpos = ht.rpos;
+
+	hits.push_back(ht);
+	hit &h = hits.back();
+	h.qname = hmem.copy(ht.qname, strlen(ht.qname) + 1);
+	h.cigar = hmem.copy(ht.cigar, ht.n_cigar);
+	if(ht.n_spos >= 1) h.spos = hmem.copy(ht.spos, ht.n_spos);
+
+	vector<int64_t> vm;
+	vector<int64_t> vi;
+	vector<int64_t> vd;
+	h.get_mid_intervals(vm, vi, vd);
+	for(int k = 0; k < vm.size(); k++) mmap.add(high32(vm[k]), low32(vm[k]), h.weight);
+	for(int k = 0; k < vi.size(); k++) imap.add(high32(vi[k]), low32(vi[k]), h.weight);
+	for(int k = 0; k < vd.size(); k++) imap.add(high32(vd[k]), low32(vd[k]), h.weight);
+	return 0;
+}
+
 int bundle_base::clear()
 {
 	tid = -1;
@@ -94,6 +352,16 @@ int bundle_base::clear()
 	rpos = 0;
 	strand = '.';
 	hits.clear();
+	hmem.clear();
+	nhits = 0;
+	n0 = np = nq = 0;
+	cpos = -1;
+	cover.clear();
+	cmem.clear();
+	chits.clear();
+	jstat.clear();
+	jmax = 1024;
+	mates.clear();
 	mmap.clear();
 	imap.clear();
 	return 0;
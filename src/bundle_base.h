@@ -11,9 +11,13 @@ See LICENSE for licensing.
 #include <cstring>
 #include <string>
 #include <vector>
+#include <map>
 
 #include "hit.h"
-#include "interval_map.h"
+#include "arena.h"
+#include "junction.h"
+#include "mate_table.h"
+#include "coverage.h"
 
 using namespace std;
 
@@ -21,6 +25,8 @@ class bundle_base
 {
 public:
 	bundle_base();
+	bundle_base(bundle_base &&bb) = default;
+	bundle_base& operator=(bundle_base &&bb) = default;
 	virtual ~bundle_base();
 
 public:
@@ -29,14 +35,34 @@ public:
 	int32_t lpos;					// the leftmost boundary on reference
 	int32_t rpos;					// the rightmost boundary on reference
 	char strand;					// strandness
-	vector<hit> hits;				// hits
-	split_interval_map mmap;		// matched interval map
-	split_interval_map imap;		// indel interval map
+	vector<hit> hits;				// hits, left empty with streaming_bundles
+	arena hmem;						// query names, cigars and splice positions of hits
+	coverage mmap;					// matched coverage, built by bundle
+	coverage imap;					// indel coverage, built by bundle
+	int nhits;						// number of hits
+	int n0, np, nq;					// number of hits with xs '.', '+' and '-'
+	vector<junction> jstat;			// junctions of hits, with xs as strand, not yet counted
+	int jmax;						// size of jstat at which its identical entries are merged
+	mate_table mates;				// fragments of hits, with streaming_bundles
+	int32_t cpos;					// position of the last hit
+	vector<hit> cover;				// distinct alignments at cpos, weighted, not yet in mmap and imap
+	arena cmem;						// cigars of cover not kept in hmem, released with cover
+	vector<int> chits;				// hits at cpos that identical single-end hits collapse into
 
 public:
 	int add_hit(const hit &ht);
-	bool overlap(const hit &ht) const;
+	int add_coverage();
+	int add_junctions(const hit &ht, const int64_t *v, int n);
+	int merge_junctions();
+	int split(vector<bundle_base> &v);
+	bool hopeless() const;
 	int clear();
+
+private:
+	int find_valleys(vector<int32_t> &cuts);
+	int add_weighted_hit(const hit &ht);
+	bool collapsible(const hit &ht) const;
+	bool collapse_hit(const hit &ht);
 };
 
 #endif
@@ -24,6 +24,8 @@ uint32_t min_mapping_quality = 1;
 int32_t min_splice_boundary_hits = 1;
 bool use_second_alignment = false;
 bool uniquely_mapped_only = false;
+bool streaming_bundles = false;
+double split_valley_ratio = 0;
 int library_type = EMPTY;
 
 // for preview
@@ -74,6 +76,9 @@ string output_file;
 bool output_tex_files = false;
 string fixed_gene_name = "";
 int batch_bundle_size = 100;
+int min_parallel_regions = 1000;
+int num_threads = 1;
+int num_decompress_threads = 0;
 int verbose = 1;
 string version = "v0.10.3";
 
@@ -326,6 +331,18 @@ int parse_arguments(int argc, const char ** argv)
 			else uniquely_mapped_only = false;
 			i++;
 		}
+		else if(string(argv[i]) == "--streaming_bundles")
+		{
+			string s(argv[i + 1]);
+			if(s == "true") streaming_bundles = true;
+			else streaming_bundles = false;
+			i++;
+		}
+		else if(string(argv[i]) == "--split_valley_ratio")
+		{
+			split_valley_ratio = atof(argv[i + 1]);
+			i++;
+		}
 		else if(string(argv[i]) == "--verbose")
 		{
 			verbose = atoi(argv[i + 1]);
@@ -336,8 +353,27 @@ int parse_arguments(int argc, const char ** argv)
 			batch_bundle_size = atoi(argv[i + 1]);
 			i++;
 		}
+		else if(string(argv[i]) == "--min_parallel_regions")
+		{
+			min_parallel_regions = atoi(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--threads")
+		{
+			num_threads = atoi(argv[i + 1]);
+			i++;
+		}
+		else if(string(argv[i]) == "--decompress_threads")
+		{
+			num_decompress_threads = atoi(argv[i + 1]);
+			i++;
+		}
 	}
 
+	// the debugging mode stops at the given gene, which requires bundles in order
+	if(fixed_gene_name != "") num_threads = 1;
+	if(num_threads < 1) num_threads = 1;
+
 	if(min_surviving_edge_weight < 0.1 + min_transcript_coverage) 
 	{
 		min_surviving_edge_weight = 0.1 + min_transcript_coverage;
@@ -417,8 +453,13 @@ int print_parameters()
 	printf("fixed_gene_name = %s\n", fixed_gene_name.c_str());
 	printf("use_second_alignment = %c\n", use_second_alignment ? 'T' : 'F');
 	printf("uniquely_mapped_only = %c\n", uniquely_mapped_only ? 'T' : 'F');
+	printf("streaming_bundles = %c\n", streaming_bundles ? 'T' : 'F');
+	printf("split_valley_ratio = %.3lf\n", split_valley_ratio);
 	printf("verbose = %d\n", verbose);
 	printf("batch_bundle_size = %d\n", batch_bundle_size);
+	printf("min_parallel_regions = %d\n", min_parallel_regions);
+	printf("num_threads = %d\n", num_threads);
+	printf("num_decompress_threads = %d\n", num_decompress_threads);
 
 	printf("\n");
 
@@ -464,6 +505,8 @@ int print_help()
 	printf(" %-42s  %s\n", "--help",  "print usage of Scallop and exit");
 	printf(" %-42s  %s\n", "--version",  "print current version of Scallop and exit");
 	printf(" %-42s  %s\n", "--verbose <0, 1, 2>",  "0: quiet; 1: one line for each graph; 2: with details, default: 1");
+	printf(" %-42s  %s\n", "--threads <integer>",  "number of threads for assembling bundles, default: 1");
+	printf(" %-42s  %s\n", "--decompress_threads <integer>",  "number of threads for decompressing the input, default: 0");
 	printf(" %-42s  %s\n", "--library_type <first, second, unstranded>",  "library type of the sample, default: unstranded");
 	printf(" %-42s  %s\n", "--min_transcript_coverage <float>",  "minimum coverage required for a multi-exon transcript, default: 1.01");
 	printf(" %-42s  %s\n", "--min_single_exon_coverage <float>",  "minimum coverage required for a single-exon transcript, default: 20");
@@ -475,6 +518,9 @@ int print_help()
 	printf(" %-42s  %s\n", "--min_num_hits_in_bundle <integer>",  "minimum number of reads required in a bundle, default: 20");
 	printf(" %-42s  %s\n", "--min_flank_length <integer>",  "minimum match length in each side for a spliced read, default: 3");
 	printf(" %-42s  %s\n", "--min_splice_bundary_hits <integer>",  "minimum number of spliced reads required for a junction, default: 1");
+	printf(" %-42s  %s\n", "--streaming_bundles <true, false>",  "summarize reads as they arrive instead of keeping them, reads without NH taken as unique, default: false");
+	printf(" %-42s  %s\n", "--split_valley_ratio <float>",  "split bundles at coverage valleys below this ratio of both sides, default: 0 (off)");
+	printf(" %-42s  %s\n", "--min_parallel_regions <integer>",  "minimum number of regions to build a bundle with all threads, default: 1000");
 	return 0;
 }
 
@@ -15,8 +15,6 @@ See LICENSE for licensing.
 using namespace std;
 
 //// constants
-#define MAX_NUM_CIGAR 7
-
 #define START_BOUNDARY 1
 #define END_BOUNDARY 2
 #define LEFT_SPLICE 3
@@ -51,6 +49,8 @@ extern uint32_t min_mapping_quality;
 extern int32_t min_splice_boundary_hits;
 extern bool uniquely_mapped_only;
 extern bool use_second_alignment;
+extern bool streaming_bundles;
+extern double split_valley_ratio;
 
 // for preview
 extern bool preview_only;
@@ -102,6 +102,9 @@ extern int max_num_bundles;
 extern int library_type;
 extern int min_gtf_transcripts_num;
 extern int batch_bundle_size;
+extern int min_parallel_regions;
+extern int num_threads;
+extern int num_decompress_threads;
 extern int verbose;
 extern string version;
 
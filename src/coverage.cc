@@ -0,0 +1,127 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+
+#include "coverage.h"
+
+static bool event_cmp(const PI32 &x, const PI32 &y)
+{
+	return x.first < y.first;
+}
+
+coverage::coverage()
+{}
+
+int coverage::add(int32_t l, int32_t r, int32_t w)
+{
+	if(l >= r || w == 0) return 0;
+	events.push_back(PI32(l, w));
+	events.push_back(PI32(r, -w));
+	return 0;
+}
+
+int coverage::build()
+{
+	if(events.size() == 0) return 0;
+
+	// existing segments take part as events, to keep their boundaries
+	for(int i = 0; i < lpos.size(); i++)
+	{
+		events.push_back(PI32(lpos[i], cov[i]));
+		events.push_back(PI32(rpos[i], -cov[i]));
+	}
+
+	lpos.clear();
+	rpos.clear();
+	cov.clear();
+
+	sort(events.begin(), events.end(), event_cmp);
+
+	// prefix sum of the weight changes, one segment between two event positions
+	int32_t c = 0;
+	int32_t q = 0;
+	int k = 0;
+	while(k < events.size())
+	{
+		int32_t p = events[k].first;
+		if(c != 0)
+		{
+			lpos.push_back(q);
+			rpos.push_back(p);
+			cov.push_back(c);
+		}
+
+		for(; k < events.size() && events[k].first == p; k++) c += events[k].second;
+		q = p;
+	}
+	assert(c == 0);
+
+	vector<PI32>().swap(events);
+
+	slen.assign(lpos.size() + 1, 0);
+	scov.assign(lpos.size() + 1, 0);
+	ssqr.assign(lpos.size() + 1, 0);
+	for(int i = 0; i < lpos.size(); i++)
+	{
+		int64_t l = rpos[i] - lpos[i];
+		int64_t w = cov[i];
+		slen[i + 1] = slen[i] + l;
+		scov[i + 1] = scov[i] + l * w;
+		ssqr[i + 1] = ssqr[i] + l * w * w;
+	}
+	return 0;
+}
+
+int coverage::clear()
+{
+	lpos.clear();
+	rpos.clear();
+	cov.clear();
+	slen.clear();
+	scov.clear();
+	ssqr.clear();
+	events.clear();
+	return 0;
+}
+
+int coverage::size() const
+{
+	return lpos.size();
+}
+
+int coverage::find(int32_t p) const
+{
+	int k = upper_bound(lpos.begin(), lpos.end(), p) - lpos.begin() - 1;
+	if(k < 0 || rpos[k] <= p) return -1;
+	return k;
+}
+
+int64_t coverage::sum_length(int p, int q) const
+{
+	return slen[q + 1] - slen[p];
+}
+
+int64_t coverage::sum_coverage(int p, int q) const
+{
+	return scov[q + 1] - scov[p];
+}
+
+int64_t coverage::sum_squares(int p, int q) const
+{
+	return ssqr[q + 1] - ssqr[p];
+}
+
+int coverage::print() const
+{
+	for(int i = 0; i < lpos.size(); i++)
+	{
+		printf("segment [%d, %d) -> %d\n", lpos[i], rpos[i], cov[i]);
+	}
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __COVERAGE_H__
+#define __COVERAGE_H__
+
+#include <stdint.h>
+#include <vector>
+
+#include "util.h"
+
+using namespace std;
+
+// coverage of a bundle as a flat array of segments, built in one pass from
+// the start and end events of the added intervals; the segments are the
+// same as those of a split_interval_map filled with the same intervals:
+// every interval boundary splits, and uncovered segments are left out;
+// prefix sums over the segments give the sums over any range of them
+class coverage
+{
+public:
+	coverage();
+
+public:
+	vector<int32_t> lpos;			// left positions of segments
+	vector<int32_t> rpos;			// right positions of segments
+	vector<int32_t> cov;			// coverage of segments
+	vector<int64_t> slen;			// prefix sums of lengths of segments
+	vector<int64_t> scov;			// prefix sums of length * coverage
+	vector<int64_t> ssqr;			// prefix sums of length * coverage^2
+
+private:
+	vector<PI32> events;			// (position, weight change) not yet in segments
+
+public:
+	int add(int32_t l, int32_t r, int32_t w);
+	int build();
+	int clear();
+	int size() const;
+	int find(int32_t p) const;
+	int64_t sum_length(int p, int q) const;
+	int64_t sum_coverage(int p, int q) const;
+	int64_t sum_squares(int p, int q) const;
+	int print() const;
+};
+
+#endif
@@ -0,0 +1,28 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "fragment.h"
+#include "util.h"
+
+fragment::fragment(const hit &h)
+	: qname(h.qname), hi(h.hi), end(-1)
+{}
+
+int fragment::add_hit(const hit &h)
+{
+	vector<int64_t> v;
+	h.get_matched_intervals(v);
+
+	sig.push_back(pack(v.size(), h.isize < 0 ? 1 : 0));
+	sig.insert(sig.end(), v.begin(), v.end());
+
+	// the mate starts at mpos; other alignments of a scattered
+	// read may show up anywhere in the bundle
+	if(h.pos > end) end = h.pos;
+	if(h.mpos > end) end = h.mpos;
+	if(h.scattered() == true) end = INT32_MAX;
+	return 0;
+}
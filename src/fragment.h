@@ -0,0 +1,35 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __FRAGMENT_H__
+#define __FRAGMENT_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "hit.h"
+
+using namespace std;
+
+// the hits of a bundle sharing query name and HI, i.e., the hits that
+// build_hyper_edges2 phases together, summarized in the order they arrive
+class fragment
+{
+public:
+	fragment(const hit &h);
+
+public:
+	string qname;			// query name
+	int hi;					// HI aux of the hits
+	int32_t end;			// no further hit of this fragment starts after end
+	vector<int64_t> sig;	// for each hit, pack(#intervals, isize < 0) followed by its matched intervals
+
+public:
+	int add_hit(const hit &h);
+};
+
+#endif
@@ -13,72 +13,133 @@ See LICENSE for licensing.
 #include "hit.h"
 #include "config.h"
 
-hit::hit(int32_t p)
+// FNV-1a, enough to spread query names; equal hashes are resolved by the names
+static uint64_t hash_qname(const char *q)
 {
-	bam1_core_t::pos = p;
+	uint64_t h = 14695981039346656037ull;
+	for(; *q != '\0'; q++)
+	{
+		h ^= (uint8_t)(*q);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+hit::hit(bam1_t *b)
+{
+	const bam1_core_t &p = b->core;
+	tid = p.tid;
+	pos = p.pos;
+	isize = p.isize;
+	mpos = -1;
+	if((p.flag & 0x1) >= 1 && (p.flag & 0x8) <= 0 && p.mtid == p.tid) mpos = p.mpos;
+	flag = p.flag;
+	qual = p.qual;
+	n_cigar = p.n_cigar;
+
+	// query name and cigar stay in the record for now
+	qname = bam_get_qname(b);
+	qhash = hash_qname(qname);
+	cigar = bam_get_cigar(b);
+	spos = NULL;
+	n_spos = 0;
+
+	// compute rpos
+	rpos = pos + (int32_t)bam_cigar2rlen(n_cigar, cigar);
+	qlen = (int32_t)bam_cigar2qlen(n_cigar, cigar);
+
+	assert(n_cigar >= 1);
+
 	strand = '.';
 	xs = '.';
 	hi = -1;
 	nh = -1;
 	nm = 0;
-	qlen = 0;
+	weight = 1;
 }
 
-hit::hit(const hit &h)
-	:bam1_core_t(h)
+// two-character aux tag as one integer, for switching over tags
+#define AUX_TAG(x, y) ((((uint16_t)(uint8_t)(x)) << 8) | ((uint16_t)(uint8_t)(y)))
+
+// size of an aux value of type t starting at p, -1 if malformed
+static int aux_size(char t, const uint8_t *p, const uint8_t *e)
 {
-	rpos = h.rpos;
-	qlen = h.qlen;
-	qname = h.qname;
-	strand = h.strand;
-	spos = h.spos;
-	xs = h.xs;
-	hi = h.hi;
-	nm = h.nm;
-	memcpy(cigar, h.cigar, sizeof cigar);
+	switch(t)
+	{
+		case 'A': case 'c': case 'C': return 1;
+		case 's': case 'S': return 2;
+		case 'i': case 'I': case 'f': return 4;
+		case 'd': return 8;
+		case 'Z': case 'H':
+		{
+			const uint8_t *q = p;
+			while(q < e && *q != '\0') q++;
+			if(q >= e) return -1;
+			return q - p + 1;
+		}
+		case 'B':
+		{
+			if(p + 5 > e) return -1;
+			uint32_t n;
+			memcpy(&n, p + 1, 4);
+			int k = aux_size(p[0], NULL, NULL);
+			if(k <= 0 || k == 8) return -1;
+			return 5 + n * k;
+		}
+	}
+	return -1;
 }
 
-hit::hit(bam1_t *b)
-	:bam1_core_t(b->core)
+// read an integer aux value of any width, false if t is not an integer type
+static bool aux_int(char t, const uint8_t *p, int64_t &x)
 {
-	// fetch query name
-	char buf[1024];
-	char *q = bam_get_qname(b);
-	int l = strlen(q);
-	memcpy(buf, q, l);
-	buf[l] = '\0';
-	qname = string(buf);
-
-	// compute rpos
-	rpos = pos + (int32_t)bam_cigar2rlen(n_cigar, bam_get_cigar(b));
-	qlen = (int32_t)bam_cigar2qlen(n_cigar, bam_get_cigar(b));
-
-	// copy cigar
-	assert(n_cigar <= MAX_NUM_CIGAR);
-	assert(n_cigar >= 1);
-	memcpy(cigar, bam_get_cigar(b), 4 * n_cigar);
+	switch(t)
+	{
+		case 'c': { int8_t v; memcpy(&v, p, 1); x = v; return true; }
+		case 'C': { uint8_t v; memcpy(&v, p, 1); x = v; return true; }
+		case 's': { int16_t v; memcpy(&v, p, 2); x = v; return true; }
+		case 'S': { uint16_t v; memcpy(&v, p, 2); x = v; return true; }
+		case 'i': { int32_t v; memcpy(&v, p, 4); x = v; return true; }
+		case 'I': { uint32_t v; memcpy(&v, p, 4); x = v; return true; }
+	}
+	return false;
 }
 
 int hit::set_tags(bam1_t *b)
 {
 	xs = '.';
-	uint8_t *p1 = bam_aux_get(b, "XS");
-	if(p1 && (*p1) == 'A') xs = bam_aux2A(p1);
-
 	hi = -1;
-	uint8_t *p2 = bam_aux_get(b, "HI");
-	if(p2 && (*p2) == 'C') hi = bam_aux2i(p2);
-
 	nh = -1;
-	uint8_t *p3 = bam_aux_get(b, "NH");
-	if(p3 && (*p3) == 'C') nh = bam_aux2i(p3);
-
 	nm = 0;
-	uint8_t *p4 = bam_aux_get(b, "nM");
-	if(p4 && (*p4) == 'C') nm = bam_aux2i(p4);
 
-	uint8_t *p5 = bam_aux_get(b, "NM");
-	if(p5 && (*p5) == 'C') nm = bam_aux2i(p5);
+	// walk the aux block once; NM takes precedence over nM wherever they are
+	bool has_nm = false;
+	const uint8_t *p = bam_get_aux(b);
+	const uint8_t *e = b->data + b->l_data;
+	while(p + 3 <= e)
+	{
+		uint16_t tag = AUX_TAG(p[0], p[1]);
+		char t = p[2];
+		p += 3;
+
+		int l = aux_size(t, p, e);
+		if(l < 0 || p + l > e) break;
+
+		int64_t x = 0;
+		bool c = aux_int(t, p, x);
+
+		// to record another tag, add its case here
+		switch(tag)
+		{
+			case AUX_TAG('X', 'S'): if(t == 'A') xs = p[0]; break;
+			case AUX_TAG('H', 'I'): if(c == true) hi = x; break;
+			case AUX_TAG('N', 'H'): if(c == true) nh = x; break;
+			case AUX_TAG('n', 'M'): if(c == true && has_nm == false) nm = x; break;
+			case AUX_TAG('N', 'M'): if(c == true) { nm = x; has_nm = true; } break;
+		}
+
+		p += l;
+	}
 
 	return 0;
 }
@@ -128,31 +189,49 @@ int hit::set_strand()
 	return 0;
 }
 
-int hit::build_splice_positions()
+// whether cigar operation c aligns read bases to reference bases;
+// long-read aligners often write = and X instead of M
+static inline bool match_op(uint32_t c)
 {
-	spos.clear();
+	int o = bam_cigar_op(c);
+	return (o == BAM_CMATCH || o == BAM_CEQUAL || o == BAM_CDIFF);
+}
+
+int hit::get_splice_positions(int64_t *v) const
+{
+	// count the splice positions, and also write them if v is not NULL;
+	// a flank is the run of matching operations next to the skip
+	int n = 0;
 	int32_t p = pos;
-	int32_t q = 0;
-	//uint8_t *seq = bam_get_seq(b);
+	int32_t f = 0;		// length of the run of matching operations ending at k
     for(int k = 0; k < n_cigar; k++)
 	{
 		if (bam_cigar_type(bam_cigar_op(cigar[k]))&2)
 			p += bam_cigar_oplen(cigar[k]);
 
-		if (bam_cigar_type(bam_cigar_op(cigar[k]))&1)
-			q += bam_cigar_oplen(cigar[k]);
+		int32_t f1 = f;
+		if(match_op(cigar[k]) == true) f += bam_cigar_oplen(cigar[k]);
+		else f = 0;
 
 		if(k == 0 || k == n_cigar - 1) continue;
 		if(bam_cigar_op(cigar[k]) != BAM_CREF_SKIP) continue;
-		if(bam_cigar_op(cigar[k-1]) != BAM_CMATCH) continue;
-		if(bam_cigar_op(cigar[k+1]) != BAM_CMATCH) continue;
-		if(bam_cigar_oplen(cigar[k-1]) < min_flank_length) continue;
-		if(bam_cigar_oplen(cigar[k+1]) < min_flank_length) continue;
+		if(match_op(cigar[k-1]) == false) continue;
+		if(match_op(cigar[k+1]) == false) continue;
+		if(f1 < min_flank_length) continue;
+
+		int32_t f2 = 0;
+		for(int j = k + 1; j < n_cigar && match_op(cigar[j]) == true; j++)
+		{
+			f2 += bam_cigar_oplen(cigar[j]);
+			if(f2 >= min_flank_length) break;
+		}
+		if(f2 < min_flank_length) continue;
 
 		int32_t s = p - bam_cigar_oplen(cigar[k]);
-		spos.push_back(pack(s, p));
+		if(v != NULL) v[n] = pack(s, p);
+		n++;
 	}
-	return 0;
+	return n;
 }
 
 bool hit::verify_junctions()
@@ -189,13 +268,32 @@ bool hit::verify_junctions()
 
 bool hit::operator<(const hit &h) const
 {
-	if(qname < h.qname) return true;
-	if(qname > h.qname) return false;
+	// names are compared only for equal hashes, which keeps colliding names apart
+	if(qhash < h.qhash) return true;
+	if(qhash > h.qhash) return false;
+	int c = strcmp(qname, h.qname);
+	if(c < 0) return true;
+	if(c > 0) return false;
 	if(hi != -1 && h.hi != -1 && hi < h.hi) return true;
 	if(hi != -1 && h.hi != -1 && hi > h.hi) return false;
 	return (pos < h.pos);
 }
 
+bool hit::same_alignment(const hit &h) const
+{
+	if(pos != h.pos) return false;
+	if(n_cigar != h.n_cigar) return false;
+	return (memcmp(cigar, h.cigar, n_cigar * sizeof(uint32_t)) == 0);
+}
+
+bool hit::scattered() const
+{
+	// other alignments of the read, without HI to tell them apart, may
+	// lie anywhere and are grouped with this one by name; reads without
+	// NH are taken as uniquely mapped
+	return (hi == -1 && nh >= 2);
+}
+
 int hit::print() const
 {
 	// get cigar string
@@ -207,8 +305,8 @@ int hit::print() const
 	}
 
 	// print basic information
-	printf("Hit %s: [%d-%d), mpos = %d, cigar = %s, flag = %d, quality = %d, strand = %c, isize = %d, qlen = %d, hi = %d\n", 
-			qname.c_str(), pos, rpos, mpos, sstr.str().c_str(), flag, qual, strand, isize, qlen, hi);
+	printf("Hit %s: [%d-%d), cigar = %s, flag = %d, quality = %d, strand = %c, isize = %d, qlen = %d, hi = %d\n", 
+			qname, pos, rpos, sstr.str().c_str(), flag, qual, strand, isize, qlen, hi);
 
 	return 0;
 }
@@ -226,9 +324,15 @@ int hit::get_mid_intervals(vector<int64_t> &vm, vector<int64_t> &vi, vector<int6
 			p += bam_cigar_oplen(cigar[k]);
 		}
 
-		if(bam_cigar_op(cigar[k]) == BAM_CMATCH)
+		if(match_op(cigar[k]) == true)
 		{
+			// consecutive matching operations (e.g., = and X) form one block
 			int32_t s = p - bam_cigar_oplen(cigar[k]);
+			if(k >= 1 && match_op(cigar[k - 1]) == true)
+			{
+				s = high32(vm.back());
+				vm.pop_back();
+			}
 			vm.push_back(pack(s, p));
 		}
 
@@ -41,32 +41,44 @@ typedef struct {
 } bam1_core_t;
 */
 
-class hit: public bam1_core_t
+// a hit keeps only the fields read downstream; the query name, cigar and
+// splice positions point into the bam record until the hit is added to
+// a bundle, which then copies them into its arena (see bundle_base::add_hit)
+class hit
 {
 public:
-	hit(int32_t p);
 	hit(bam1_t *b);
-	hit(const hit &h);
 	bool operator<(const hit &h) const;
+	bool same_alignment(const hit &h) const;
+	bool scattered() const;
 
 public:
+	int32_t tid;							// chromosome ID
+	int32_t pos;							// 0-based leftmost coordinate
 	int32_t rpos;							// right position mapped to reference [pos, rpos)
+	int32_t isize;							// insert size
+	int32_t mpos;							// position of the mate, -1 if not mapped to this chromosome
 	int32_t qlen;							// read length
-	string qname;							// query name
-	char strand;							// strandness
-	char xs;								// XS aux in sam
 	int32_t nh;								// NH aux in sam
 	int32_t hi;								// HI aux in sam
-	int32_t nm;								// NM aux in sam
-	bool concordant;						// whether it is concordant
-	uint32_t cigar[MAX_NUM_CIGAR];			// cigar, use samtools
-	vector<int64_t> spos;					// splice positions
+	int32_t nm;								// NM aux in sam, summed over collapsed hits
+	int32_t weight;							// number of identical alignments collapsed into this hit
+	uint64_t qhash;							// hash of the query name
+	const char *qname;						// query name
+	const uint32_t *cigar;					// cigar, use samtools
+	const int64_t *spos;					// splice positions
+	uint32_t n_cigar;						// number of cigar operations, not bounded
+	uint32_t n_spos;						// number of splice positions
+	uint16_t flag;							// bitwise flag
+	uint8_t qual;							// mapping quality
+	char strand;							// strandness
+	char xs;								// XS aux in sam
 
 public:
 	int set_tags(bam1_t *b);
 	int set_strand();
 	int set_concordance();
-	int build_splice_positions();
+	int get_splice_positions(int64_t *v) const;
 	bool verify_junctions();
 	int get_mid_intervals(vector<int64_t> &vm, vector<int64_t> &vi, vector<int64_t> &vd) const;
 	int get_matched_intervals(vector<int64_t> &v) const;
@@ -215,6 +215,113 @@ int evaluate_triangle(const split_interval_map &imap, int ll, int rr, double &av
 	return 0;
 }
 
+int compute_overlap(const coverage &cv, int32_t p)
+{
+	int k = cv.find(p);
+	if(k == -1) return 0;
+	return cv.cov[k];
+}
+
+PI locate_boundary_iterators(const coverage &cv, int32_t x, int32_t y)
+{
+	// the first and the last segments inside [x, y)
+	int l = lower_bound(cv.lpos.begin(), cv.lpos.end(), x) - cv.lpos.begin();
+	int r = upper_bound(cv.rpos.begin(), cv.rpos.end(), y) - cv.rpos.begin() - 1;
+
+	if(l >= cv.size() || cv.rpos[l] > y) l = -1;
+	if(r < 0 || cv.lpos[r] < x) r = -1;
+
+	if(l == -1) assert(r == -1);
+	if(r == -1) assert(l == -1);
+
+	return PI(l, r);
+}
+
+int64_t compute_sum_overlap(const coverage &cv, int p, int q)
+{
+	if(p == -1) return 0;
+	return cv.sum_coverage(p, q);
+}
+
+int evaluate_rectangle(const coverage &cv, int ll, int rr, double &ave, double &dev)
+{
+	ave = 0;
+	dev = 1.0;
+
+	int l, r;
+	tie(l, r) = locate_boundary_iterators(cv, ll, rr);
+
+	if(l == -1) return 0;
+	if(r == -1) return 0;
+
+	int64_t s0 = cv.sum_length(l, r);
+	int64_t s1 = cv.sum_coverage(l, r);
+	int64_t s2 = cv.sum_squares(l, r);
+
+	ave = 1.0 * s1 / (rr - ll);
+
+	// sum of length * (coverage - ave)^2 over the segments, expanded
+	long double a = (long double)(s1) / (rr - ll);
+	long double var = s2 - 2 * a * s1 + a * a * s0;
+	if(var < 0) var = 0;
+
+	dev = sqrt((double)(var / (rr - ll)));
+
+	return 0;
+}
+
+int evaluate_triangle(const coverage &cv, int ll, int rr, double &ave, double &dev)
+{
+	ave = 0;
+	dev = 1.0;
+
+	int l, r;
+	tie(l, r) = locate_boundary_iterators(cv, ll, rr);
+
+	if(l == -1) return 0;
+	if(r == -1) return 0;
+
+	double xm = 0;
+	double ym = 0;
+	for(int k = l; k <= r; k++)
+	{
+		xm += (cv.lpos[k] + cv.rpos[k]) / 2.0;
+		ym += cv.cov[k];
+	}
+
+	xm /= (r - l + 1);
+	ym /= (r - l + 1);
+
+	double f1 = 0;
+	double f2 = 0;
+	for(int k = l; k <= r; k++)
+	{
+		double xi = (cv.lpos[k] + cv.rpos[k]) / 2.0;
+		f1 += (xi - xm) * (cv.cov[k] - ym);
+		f2 += (xi - xm) * (xi - xm);
+	}
+
+	double b1 = f1 / f2;
+	double b0 = ym - b1 * xm;
+
+	double a1 = b1 * rr + b0;
+	double a0 = b1 * ll + b0;
+	ave = (a1 > a0) ? a1 : a0;
+
+	double var = 0;
+	for(int k = l; k <= r; k++)
+	{
+		double xi = (cv.rpos[k] + cv.lpos[k]) / 2.0;
+		double yi = b1 * xi + b0;
+		var += (cv.cov[k] - yi) * (cv.cov[k] - yi) * (cv.rpos[k] - cv.lpos[k]);
+	}
+
+	dev = sqrt(var / (rr - ll));
+	if(dev < 1.0) dev = 1.0;
+
+	return 0;
+}
+
 int test_split_interval_map()
 {
 	split_interval_map imap;
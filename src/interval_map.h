@@ -13,6 +13,8 @@ See LICENSE for licensing.
 
 #include <vector>
 
+#include "coverage.h"
+
 using namespace boost;
 using namespace std;
 
@@ -56,6 +58,13 @@ int compute_sum_overlap(const split_interval_map &imap, SIMI &p, SIMI &q);
 int evaluate_rectangle(const split_interval_map &imap, int ll, int rr, double &ave, double &dev);
 int evaluate_triangle(const split_interval_map &imap, int ll, int rr, double &ave, double &dev);
 
+// the same on a coverage array, where segments are given by indices, -1 for none
+int compute_overlap(const coverage &cv, int32_t p);
+PI locate_boundary_iterators(const coverage &cv, int32_t x, int32_t y);
+int64_t compute_sum_overlap(const coverage &cv, int p, int q);
+int evaluate_rectangle(const coverage &cv, int ll, int rr, double &ave, double &dev);
+int evaluate_triangle(const coverage &cv, int ll, int rr, double &ave, double &dev);
+
 // testing
 int test_split_interval_map();
 
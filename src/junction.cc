@@ -64,3 +64,10 @@ bool junction_cmp_length(const junction &x, const junction &y)
 	if(p1 < p2) return true;
 	else return false;
 }
+
+bool junction_cmp_position(const junction &x, const junction &y)
+{
+	if(x.lpos != y.lpos) return (x.lpos < y.lpos);
+	if(x.rpos != y.rpos) return (x.rpos < y.rpos);
+	return (x.strand < y.strand);
+}
@@ -37,5 +37,6 @@ public:
 };
 
 bool junction_cmp_length(const junction &x, const junction &y);
+bool junction_cmp_position(const junction &x, const junction &y);
 
 #endif
@@ -13,6 +13,8 @@ See LICENSE for licensing.
 #include <cassert>
 #include <sstream>
 
+#include "htslib/thread_pool.h"
+
 #include "config.h"
 #include "previewer.h"
 #include "assembler.h"
@@ -43,16 +45,23 @@ int main(int argc, const char **argv)
 		//print_parameters();
 	}
 
+	// one decompression pool shared by both passes over the input
+	htsThreadPool tp = {NULL, 0};
+	if(num_decompress_threads >= 1) tp.pool = hts_tpool_init(num_decompress_threads);
+
 	if(library_type == EMPTY || preview_only == true)
 	{
-		previewer pv;
+		previewer pv(&tp);
 		pv.preview();
 	}
 
-	if(preview_only == true) return 0;
+	if(preview_only == false)
+	{
+		assembler asmb(&tp);
+		asmb.assemble();
+	}
 
-	assembler asmb;
-	asmb.assemble();
+	if(tp.pool != NULL) hts_tpool_destroy(tp.pool);
 
 	return 0;
 }
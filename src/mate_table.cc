@@ -0,0 +1,79 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include "mate_table.h"
+
+int mate_table::add_hit(const hit &h)
+{
+	// hits come sorted by position, so nothing can join fragments ending before h
+	evict(h.pos);
+
+	PUI k(h.qhash, h.hi);
+	vector<fragment> &v = pending[k];
+
+	// different names sharing a hash get a fragment each
+	int i = 0;
+	while(i < v.size() && v[i].qname != h.qname) i++;
+	if(i == v.size()) v.push_back(fragment(h));
+
+	v[i].add_hit(h);
+	ends.push(PIPUI(v[i].end, k));
+	return 0;
+}
+
+int mate_table::evict(int32_t p)
+{
+	// entries are pushed for every hit, so some are outdated; they are skipped
+	while(ends.size() >= 1 && ends.top().first < p)
+	{
+		PUI k = ends.top().second;
+		ends.pop();
+
+		map< PUI, vector<fragment> >::iterator it = pending.find(k);
+		if(it == pending.end()) continue;
+
+		vector<fragment> &v = it->second;
+		vector<fragment> w;
+		for(int i = 0; i < v.size(); i++)
+		{
+			if(v[i].end < p) finish(v[i]);
+			else w.push_back(v[i]);
+		}
+
+		if(w.size() == 0) pending.erase(it);
+		else v.swap(w);
+	}
+	return 0;
+}
+
+int mate_table::finish(const fragment &fr)
+{
+	MVLI::iterator it = phases.find(fr.sig);
+	if(it == phases.end()) phases.insert(pair<vector<int64_t>, int>(fr.sig, 1));
+	else it->second++;
+	return 0;
+}
+
+int mate_table::flush()
+{
+	map< PUI, vector<fragment> >::iterator it;
+	for(it = pending.begin(); it != pending.end(); it++)
+	{
+		vector<fragment> &v = it->second;
+		for(int i = 0; i < v.size(); i++) finish(v[i]);
+	}
+	pending.clear();
+	ends = priority_queue< PIPUI, vector<PIPUI>, greater<PIPUI> >();
+	return 0;
+}
+
+int mate_table::clear()
+{
+	phases.clear();
+	pending.clear();
+	ends = priority_queue< PIPUI, vector<PIPUI>, greater<PIPUI> >();
+	return 0;
+}
@@ -0,0 +1,46 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __MATE_TABLE_H__
+#define __MATE_TABLE_H__
+
+#include <stdint.h>
+#include <map>
+#include <queue>
+#include <vector>
+
+#include "hit.h"
+#include "fragment.h"
+
+using namespace std;
+
+typedef pair<uint64_t, int> PUI;
+typedef pair<int32_t, PUI> PIPUI;
+typedef map< vector<int64_t>, int > MVLI;
+
+// fragments of a bundle whose mates may still arrive, keyed by the hash of
+// the query name and HI; once the reader passes the position of the mates,
+// a fragment is finished and only its summary is kept, with multiplicity
+class mate_table
+{
+public:
+	MVLI phases;										// summaries of finished fragments and their counts
+
+private:
+	map< PUI, vector<fragment> > pending;				// fragments that may get more hits
+	priority_queue< PIPUI, vector<PIPUI>, greater<PIPUI> > ends;	// when to look at pending fragments
+
+public:
+	int add_hit(const hit &h);
+	int flush();
+	int clear();
+
+private:
+	int evict(int32_t p);
+	int finish(const fragment &fr);
+};
+
+#endif
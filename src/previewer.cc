@@ -7,15 +7,18 @@ See LICENSE for licensing.
 #include <cstdio>
 #include <cassert>
 #include <sstream>
+#include <chrono>
 
 #include "previewer.h"
 #include "config.h"
 
-previewer::previewer()
+previewer::previewer(htsThreadPool *tp)
 {
     sfn = sam_open(input_file.c_str(), "r");
+	if(tp != NULL && tp->pool != NULL) hts_set_thread_pool(sfn, tp);
     hdr = sam_hdr_read(sfn);
     b1t = bam_init1();
+	rtime = 0;
 }
 
 previewer::~previewer()
@@ -36,7 +39,7 @@ int previewer::preview()
 	vector<int> sp1;
 	vector<int> sp2;
 
-    while(sam_read1(sfn, hdr, b1t) >= 0)
+    while(read() >= 0)
 	{
 		if(total >= max_preview_reads) break;
 		if(sp1.size() >= max_preview_spliced_reads && sp2.size() >= max_preview_spliced_reads) break;
@@ -45,7 +48,6 @@ int previewer::preview()
 
 		if((p.flag & 0x4) >= 1) continue;										// read is not mapped
 		if((p.flag & 0x100) >= 1 && use_second_alignment == false) continue;	// qstrandary alignment
-		if(p.n_cigar > MAX_NUM_CIGAR) continue;									// ignore hits with more than 7 cigar types
 		if(p.qual < min_mapping_quality) continue;								// ignore hits with small quality
 		if(p.n_cigar < 1) continue;												// should never happen
 
@@ -104,9 +106,18 @@ int previewer::preview()
 	{
 		printf("preview: reads = %d, single = %d, paired = %d, spliced reads = %d, first = %d, second = %d, inferred library_type = %s, given library_type = %s\n",
 			total, single, paired, sp, first, second, vv[s1 + 1].c_str(), vv[library_type + 1].c_str());
+		printf("preview: %.2lf seconds spent in reading and decompressing the input\n", rtime);
 	}
 
 	if(library_type == EMPTY) library_type = s1;
 
 	return 0;
 }
+
+int previewer::read()
+{
+	chrono::steady_clock::time_point t = chrono::steady_clock::now();
+	int r = sam_read1(sfn, hdr, b1t);
+	rtime += chrono::duration<double>(chrono::steady_clock::now() - t).count();
+	return r;
+}
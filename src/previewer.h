@@ -17,16 +17,20 @@ using namespace std;
 class previewer
 {
 public:
-	previewer();
+	previewer(htsThreadPool *tp);
 	~previewer();
 
 private:
 	samFile *sfn;
 	bam_hdr_t *hdr;
 	bam1_t *b1t;
+	double rtime;			// seconds spent in sam_read1, i.e., decompressing and parsing
 
 public:
 	int preview();
+
+private:
+	int read();
 };
 
 #endif
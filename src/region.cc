@@ -11,7 +11,7 @@ See LICENSE for licensing.
 
 using namespace std;
 
-region::region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const split_interval_map *_mmap, const split_interval_map *_imap)
+region::region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const coverage *_mmap, const coverage *_imap)
 	:lpos(_lpos), rpos(_rpos), mmap(_mmap), imap(_imap), ltype(_ltype), rtype(_rtype)
 {
 
@@ -28,17 +28,14 @@ int region::build_join_interval_map()
 {
 	jmap.clear();
 
-	SIMI lit, rit;
+	int lit, rit;
 	tie(lit, rit) = locate_boundary_iterators(*mmap, lpos, rpos);
-	if(lit == mmap->end() || rit == mmap->end()) return 0;
+	if(lit == -1 || rit == -1) return 0;
 
-	SIMI it = lit;
-	while(true)
+	for(int k = lit; k <= rit; k++)
 	{
-		//if(it->second >= 2) 
-		jmap += make_pair(it->first, 1);
-		if(it == rit) break;
-		it++;
+		//if(mmap->cov[k] >= 2) 
+		jmap += make_pair(ROI(mmap->lpos[k], mmap->rpos[k]), 1);
 	}
 
 	for(JIMI it = jmap.begin(); it != jmap.end(); it++)
@@ -54,9 +51,9 @@ int region::split_join_interval_map()
 	if(lower(jmap.begin()->first) != lpos) return 0;
 	if(upper(jmap.begin()->first) == rpos) return 0;
 
-	SIMI lit, rit;
+	int lit, rit;
 	tie(lit, rit) = locate_boundary_iterators(*mmap, lpos, rpos);
-	if(lit == mmap->end() || rit == mmap->end()) return 0;
+	if(lit == -1 || rit == -1) return 0;
 
 	int32_t min_split_middle_length = 10;
 	int32_t min_split_boundary_length = 40;
@@ -66,11 +63,11 @@ int region::split_join_interval_map()
 	if(rpos - lpos < 100) return 0;
 
 	int32_t p = lpos;
-	for(SIMI it = lit; it != rit; it++)
+	for(int k = lit; k < rit; k++)
 	{
-		int32_t p1 = lower(it->first);
-		int32_t p2 = upper(it->first);
-		int32_t cov = it->second;
+		int32_t p1 = mmap->lpos[k];
+		int32_t p2 = mmap->rpos[k];
+		int32_t cov = mmap->cov[k];
 
 		if(cov <= max_split_middle_coverage) continue;
 
@@ -140,11 +137,11 @@ bool region::empty_subregion(int32_t p1, int32_t p2)
 	//printf(" region = [%d, %d), subregion [%d, %d), length = %d\n", lpos, rpos, p1, p2, p2 - p1);
 	if(p2 - p1 < min_subregion_length) return true;
 
-	SIMI it1, it2;
+	int it1, it2;
 	tie(it1, it2) = locate_boundary_iterators(*mmap, p1, p2);
-	if(it1 == mmap->end() || it2 == mmap->end()) return true;
+	if(it1 == -1 || it2 == -1) return true;
 
-	int32_t sum = compute_sum_overlap(*mmap, it1, it2);
+	int64_t sum = compute_sum_overlap(*mmap, it1, it2);
 	double ratio = sum * 1.0 / (p2 - p1);
 	//printf(" region = [%d, %d), subregion [%d, %d), overlap = %.2lf\n", lpos, rpos, p1, p2, ratio);
 	//if(ratio < min_subregion_overlap + max_intron_contamination_coverage) return true;
@@ -19,7 +19,7 @@ typedef pair<int, int> PI;
 class region
 {
 public:
-	region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const split_interval_map *_mmap, const split_interval_map *_imap);
+	region(int32_t _lpos, int32_t _rpos, int _ltype, int _rtype, const coverage *_mmap, const coverage *_imap);
 	~region();
 
 public:
@@ -27,8 +27,8 @@ public:
 	int32_t rpos;					// the rightmost boundary on reference
 	int ltype;						// type of the left boundary
 	int rtype;						// type of the right boundary
-	const split_interval_map *mmap;	// pointer to match interval map
-	const split_interval_map *imap;	// pointer to indel interval map
+	const coverage *mmap;			// pointer to match coverage
+	const coverage *imap;			// pointer to indel coverage
 	join_interval_map jmap;			// subregion intervals
 
 	vector<partial_exon> pexons;	// generated partial exons
@@ -18,6 +18,21 @@ scallop::scallop()
 
 scallop::scallop(const splice_graph &g, const hyper_set &h)
 	: gr(g), hs(h)
+{
+	init();
+}
+
+scallop::scallop(splice_graph &&g, hyper_set &&h)
+	: gr(std::move(g)), hs(std::move(h))
+{
+	init();
+}
+
+scallop::~scallop()
+{
+}
+
+int scallop::init()
 {
 	round = 0;
 	if(output_tex_files == true) gr.draw(gr.gid + "." + tostring(round++) + ".tex");
@@ -29,10 +44,7 @@ scallop::scallop(const splice_graph &g, const hyper_set &h)
 	init_vertex_map();
 	init_inner_weights();
 	init_nonzeroset();
-}
-
-scallop::~scallop()
-{
+	return 0;
 }
 
 int scallop::assemble()
@@ -1339,8 +1351,8 @@ int scallop::collect_path(int e)
 	p.v = v;
 	paths.push_back(p);
 
-	gr.remove_edge(i2e[e]);
 	e2i.erase(i2e[e]);
+	gr.remove_edge(i2e[e]);
 	i2e[e] = null_edge;
 
 	return 0;
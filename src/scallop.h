@@ -13,7 +13,7 @@ See LICENSE for licensing.
 #include "router.h"
 #include "path.h"
 
-typedef map< edge_descriptor, vector<int> > MEV;
+typedef map< edge_descriptor, vector<int>, edge_cmp > MEV;
 typedef pair< edge_descriptor, vector<int> > PEV;
 typedef pair< vector<int>, vector<int> > PVV;
 typedef pair<PEE, int> PPEEI;
@@ -27,6 +27,7 @@ class scallop
 public:
 	scallop();
 	scallop(const splice_graph &gr, const hyper_set &hs);
+	scallop(splice_graph &&gr, hyper_set &&hs);
 	virtual ~scallop();
 
 public:
@@ -47,6 +48,7 @@ public:
 private:
 	// init
 	int classify();
+	int init();
 	int init_vertex_map();
 	int init_super_edges();
 	int init_inner_weights();
@@ -31,6 +31,41 @@ splice_graph::splice_graph(const splice_graph &gr)
 	copy(gr, x2y, y2x);
 }
 
+// edges are renumbered by copy, so weights and infos go through it as well
+splice_graph& splice_graph::operator=(const splice_graph &gr)
+{
+	if(this == &gr) return (*this);
+	chrm = gr.chrm;
+	gid = gr.gid;
+	strand = gr.strand;
+
+	MEE x2y;
+	MEE y2x;
+	copy(gr, x2y, y2x);
+	return (*this);
+}
+
+// hand over the graph without copying; edges keep their indices,
+// so weights and infos move along with them
+splice_graph::splice_graph(splice_graph &&gr) noexcept
+	: directed_graph(std::move(gr)), chrm(std::move(gr.chrm)), gid(std::move(gr.gid)), strand(gr.strand),
+	vwrt(std::move(gr.vwrt)), vinf(std::move(gr.vinf)), ewrt(std::move(gr.ewrt)), einf(std::move(gr.einf))
+{}
+
+splice_graph& splice_graph::operator=(splice_graph &&gr) noexcept
+{
+	if(this == &gr) return (*this);
+	directed_graph::operator=(std::move(gr));
+	chrm = std::move(gr.chrm);
+	gid = std::move(gr.gid);
+	strand = gr.strand;
+	vwrt = std::move(gr.vwrt);
+	vinf = std::move(gr.vinf);
+	ewrt = std::move(gr.ewrt);
+	einf = std::move(gr.einf);
+	return (*this);
+}
+
 int splice_graph::copy(const splice_graph &gr, MEE &x2y, MEE &y2x)
 {
 	clear();
@@ -49,8 +84,6 @@ int splice_graph::copy(const splice_graph &gr, MEE &x2y, MEE &y2x)
 		set_edge_info(e, gr.get_edge_info(*it));
 
 		assert(e != NULL);
-		assert(ewrt.find(e) != ewrt.end());
-		assert(einf.find(e) != einf.end());
 		assert(x2y.find(*it) == x2y.end());
 		assert(y2x.find(e) == y2x.end());
 
@@ -80,7 +113,7 @@ double splice_graph::get_vertex_weight(int v) const
 	return vwrt[v];
 }
 
-vertex_info splice_graph::get_vertex_info(int v) const
+const vertex_info& splice_graph::get_vertex_info(int v) const
 {
 	assert(v >= 0 && v < vinf.size());
 	return vinf[v];
@@ -88,16 +121,14 @@ vertex_info splice_graph::get_vertex_info(int v) const
 
 double splice_graph::get_edge_weight(edge_base *e) const
 {
-	MED::const_iterator it = ewrt.find(e);
-	assert(it != ewrt.end());
-	return it->second;
+	assert(e->index() >= 0 && e->index() < ewrt.size());
+	return ewrt[e->index()];
 }
 
-edge_info splice_graph::get_edge_info(edge_base *e) const
+const edge_info& splice_graph::get_edge_info(edge_base *e) const
 {
-	MEIF::const_iterator it = einf.find(e);
-	assert(it != einf.end());
-	return it->second;
+	assert(e->index() >= 0 && e->index() < einf.size());
+	return einf[e->index()];
 }
 
 int splice_graph::set_vertex_weight(int v, double w) 
@@ -111,28 +142,52 @@ int splice_graph::set_vertex_weight(int v, double w)
 int splice_graph::set_vertex_info(int v, const vertex_info &vi) 
 {
 	assert(v >= 0 && v < vv.size());
-	if(vinf.size() != vv.size()) vinf.resize(vv.size());
-	vinf[v] = vi;
+	if(vinf.size() == vv.size())
+	{
+		vinf[v] = vi;
+		return 0;
+	}
+
+	// vi may be an element of vinf, so it is copied before resizing
+	vertex_info x = vi;
+	vinf.resize(vv.size());
+	vinf[v] = x;
 	return 0;
 }
 
 int splice_graph::set_edge_weight(edge_base* e, double w) 
 {
-	if(ewrt.find(e) != ewrt.end()) ewrt[e] = w;
-	else ewrt.insert(PED(e, w));
+	assert(contain_edge(e) == true);
+	if(ewrt.size() != ve.size()) ewrt.resize(ve.size());
+	ewrt[e->index()] = w;
 	return 0;
 }
 
 int splice_graph::set_edge_info(edge_base* e, const edge_info &ei) 
 {
-	if(einf.find(e) != einf.end()) einf[e] = ei;
-	else einf.insert(PEIF(e, ei));
+	assert(contain_edge(e) == true);
+	if(einf.size() == ve.size())
+	{
+		einf[e->index()] = ei;
+		return 0;
+	}
+
+	// ei may be an element of einf, so it is copied before resizing
+	edge_info x = ei;
+	einf.resize(ve.size());
+	einf[e->index()] = x;
 	return 0;
 }
 
 MED splice_graph::get_edge_weights() const
 {
-	return ewrt;
+	MED med;
+	PEEI p = edges();
+	for(edge_iterator it = p.first; it != p.second; it++)
+	{
+		med.insert(PED(*it, get_edge_weight(*it)));
+	}
+	return med;
 }
 
 vector<double> splice_graph::get_vertex_weights() const
@@ -142,7 +197,10 @@ vector<double> splice_graph::get_vertex_weights() const
 
 int splice_graph::set_edge_weights(const MED &med)
 {
-	ewrt = med;
+	for(MED::const_iterator it = med.begin(); it != med.end(); it++)
+	{
+		set_edge_weight(it->first, it->second);
+	}
 	return 0;
 }
 
@@ -374,9 +432,9 @@ int splice_graph::simulate(int nv, int ne, int mw)
 		if(p.second == true) continue;
 
 		edge_descriptor e = add_edge(s, t);
-		ewrt.insert(PED(e, f));
-		einf.insert(PEIF(e, edge_info()));
-		if(ewrt.size() >= ne) break;
+		set_edge_weight(e, f);
+		set_edge_info(e, edge_info());
+		if(num_edges() >= ne) break;
 	}
 
 	assert(in_degree(0) == 0);
@@ -390,22 +448,24 @@ int splice_graph::simulate(int nv, int ne, int mw)
 		if(w <= 0) break;
 		for(int i = 0; i < v.size(); i++)
 		{
-			ewrt[v[i]] -= w;
+			ewrt[v[i]->index()] -= w;
 			if(med.find(v[i]) == med.end()) med.insert(PED(v[i], w));
 			else med[v[i]] += w;
 		}
 	}
 
-	for(MED::iterator it = ewrt.begin(); it != ewrt.end(); it++)
+	VE ve0;
+	PEEI pe = edges();
+	for(edge_iterator it = pe.first; it != pe.second; it++)
 	{
-		if(med.find(it->first) == med.end()) remove_edge(it->first);
+		if(med.find(*it) == med.end()) ve0.push_back(*it);
 	}
+	for(int i = 0; i < ve0.size(); i++) remove_edge(ve0[i]);
 
-	ewrt = med;
-	einf.clear();
-	for(MED::iterator it = ewrt.begin(); it != ewrt.end(); it++)
+	for(MED::iterator it = med.begin(); it != med.end(); it++)
 	{
-		einf.insert(PEIF(it->first, edge_info()));
+		set_edge_weight(it->first, it->second);
+		set_edge_info(it->first, edge_info());
 	}
 
 	edge_iterator it1, it2;
@@ -414,12 +474,12 @@ int splice_graph::simulate(int nv, int ne, int mw)
 		int wx = 0;
 		for(tie(it1, it2) = in_edges(i); it1 != it2; it1++)
 		{
-			wx += (int)(ewrt[*it1]);
+			wx += (int)(get_edge_weight(*it1));
 		}
 		int wy = 0;
 		for(tie(it1, it2) = out_edges(i); it1 != it2; it1++)
 		{
-			wy += (int)(ewrt[*it1]);
+			wy += (int)(get_edge_weight(*it1));
 		}
 
 		if(i == 0) assert(wx == 0);
@@ -856,11 +916,7 @@ int splice_graph::locate(int v)
 
 int splice_graph::round_weights()
 {
-	MED m = ewrt;
-	for(MED::iterator it = m.begin(); it != m.end(); it++)
-	{
-		it->second = 0.0;
-	}
+	vector<double> m(ewrt.size(), 0.0);
 
 	while(true)
 	{
@@ -890,9 +946,10 @@ int splice_graph::round_weights()
 		
 		for(int i = 0; i < v.size(); i++)
 		{
-			m[v[i]] += ww;
-			ewrt[v[i]] -= ww;
-			if(ewrt[v[i]] <= 0) ewrt[v[i]] = 0;
+			int k = v[i]->index();
+			m[k] += ww;
+			ewrt[k] -= ww;
+			if(ewrt[k] <= 0) ewrt[k] = 0;
 		}
 	}
 
@@ -901,7 +958,7 @@ int splice_graph::round_weights()
 	edge_iterator it1, it2;
 	for(tie(it1, it2) = out_edges(0); it1 != it2; it1++)
 	{
-		double w = ewrt[*it1];
+		double w = get_edge_weight(*it1);
 		vwrt[0] += w;
 	}
 
@@ -909,7 +966,7 @@ int splice_graph::round_weights()
 	{
 		for(tie(it1, it2) = in_edges(i); it1 != it2; it1++)
 		{
-			double w = ewrt[*it1];
+			double w = get_edge_weight(*it1);
 			vwrt[i] += w;
 		}
 	}
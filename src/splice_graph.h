@@ -20,14 +20,14 @@ See LICENSE for licensing.
 
 using namespace std;
 
-typedef map<edge_descriptor, edge_info> MEIF;
-typedef pair<edge_descriptor, edge_info> PEIF;
-
 class splice_graph : public directed_graph
 {
 public:
 	splice_graph();
 	splice_graph(const splice_graph &gr);
+	splice_graph& operator=(const splice_graph &gr);
+	splice_graph(splice_graph &&gr) noexcept;
+	splice_graph& operator=(splice_graph &&gr) noexcept;
 	virtual ~splice_graph();
 
 public:
@@ -37,15 +37,15 @@ public:
 
 	vector<double> vwrt;
 	vector<vertex_info> vinf;
-	MED ewrt;
-	MEIF einf;
+	vector<double> ewrt;		// edge weights, by index of edges
+	vector<edge_info> einf;		// edge infos, by index of edges
 
 public:
 	// get and set properties
 	double get_vertex_weight(int v) const;
 	double get_edge_weight(edge_base *e) const;
-	vertex_info get_vertex_info(int v) const;
-	edge_info get_edge_info(edge_base *e) const;
+	const vertex_info& get_vertex_info(int v) const;
+	const edge_info& get_edge_info(edge_base *e) const;
 
 	int set_vertex_weight(int v, double w);
 	int set_vertex_info(int v, const vertex_info &vi);
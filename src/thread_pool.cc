@@ -0,0 +1,136 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#include <cassert>
+
+#include "thread_pool.h"
+
+thread_pool::thread_pool(int n, int c)
+	: capacity(c), running(0), stop(false)
+{
+	assert(n >= 1);
+	assert(c >= 1);
+	for(int i = 0; i < n; i++)
+	{
+		workers.push_back(thread(&thread_pool::work, this));
+	}
+}
+
+thread_pool::~thread_pool()
+{
+	wait();
+
+	unique_lock<mutex> lock(mtx);
+	stop = true;
+	lock.unlock();
+	cv_task.notify_all();
+
+	for(int i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+}
+
+int thread_pool::submit(const task &t)
+{
+	unique_lock<mutex> lock(mtx);
+	while(tasks.size() >= capacity) cv_space.wait(lock);
+	tasks.push_back(t);
+	lock.unlock();
+	cv_task.notify_one();
+	return 0;
+}
+
+// items of a call of run, taken one at a time by the caller and its helpers
+struct batch
+{
+	int n;							// number of items
+	int next;						// first item not yet taken
+	int done;						// number of items finished
+	function<void(int)> f;			// work on an item
+	mutex mtx;						// protects all above
+	condition_variable cv_done;		// all items are finished
+};
+
+static int run_batch(batch &b)
+{
+	while(true)
+	{
+		unique_lock<mutex> lock(b.mtx);
+		if(b.next >= b.n) return 0;
+		int i = b.next++;
+		lock.unlock();
+
+		b.f(i);
+
+		lock.lock();
+		b.done++;
+		if(b.done == b.n) b.cv_done.notify_all();
+	}
+	return 0;
+}
+
+int thread_pool::run(int n, const function<void(int)> &f)
+{
+	// the caller works through the items itself, and helpers go to the front
+	// of the queue without waiting for space, so a task of this pool can call
+	// run too: it never waits on an item that nobody is working on
+	shared_ptr<batch> b = make_shared<batch>();
+	b->n = n;
+	b->next = 0;
+	b->done = 0;
+	b->f = f;
+
+	unique_lock<mutex> lock(mtx);
+	for(int i = 0; i < workers.size() && i < n - 1; i++)
+	{
+		tasks.push_front([b]() { run_batch(*b); });
+	}
+	lock.unlock();
+	cv_task.notify_all();
+
+	run_batch(*b);
+
+	unique_lock<mutex> block(b->mtx);
+	while(b->done < b->n) b->cv_done.wait(block);
+	return 0;
+}
+
+int thread_pool::wait()
+{
+	unique_lock<mutex> lock(mtx);
+	while(tasks.size() >= 1 || running >= 1) cv_done.wait(lock);
+	return 0;
+}
+
+int thread_pool::size() const
+{
+	return workers.size();
+}
+
+int thread_pool::work()
+{
+	while(true)
+	{
+		unique_lock<mutex> lock(mtx);
+		while(tasks.size() == 0 && stop == false) cv_task.wait(lock);
+		if(tasks.size() == 0 && stop == true) return 0;
+
+		task t = tasks.front();
+		tasks.pop_front();
+		running++;
+		lock.unlock();
+		cv_space.notify_one();
+
+		t();
+
+		lock.lock();
+		running--;
+		lock.unlock();
+		cv_done.notify_all();
+	}
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+Part of Scallop Transcript Assembler
+(c) 2017 by  Mingfu Shao, Carl Kingsford, and Carnegie Mellon University.
+See LICENSE for licensing.
+*/
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+typedef function<void()> task;
+
+// a fixed set of workers consuming a bounded queue of tasks;
+// submit blocks while the queue is full, so a fast producer
+// can never get more than capacity tasks ahead of the workers
+class thread_pool
+{
+public:
+	thread_pool(int n, int c);
+	~thread_pool();
+
+private:
+	vector<thread> workers;			// worker threads
+	deque<task> tasks;				// pending tasks
+	int capacity;					// maximum number of pending tasks
+	int running;					// number of tasks being executed
+	bool stop;						// whether workers should exit
+	mutex mtx;						// protects all above
+	condition_variable cv_task;		// a task is queued or stop is set
+	condition_variable cv_space;	// a pending task is taken
+	condition_variable cv_done;		// a task is finished
+
+public:
+	int submit(const task &t);
+	int run(int n, const function<void(int)> &f);
+	int wait();
+	int size() const;
+
+private:
+	int work();
+};
+
+#endif